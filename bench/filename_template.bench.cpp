@@ -0,0 +1,74 @@
+// Compares FilenameTemplate::expand into a reused buffer against the naive
+// approach of copying the raw template and running std::string::replace for
+// every token at each output step. The compiled expander should not
+// allocate and should stay well ahead at millions of expansions.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "xml_stream_parser.hpp"
+
+using namespace xml_stream_parser;
+
+namespace {
+
+std::string pad(int value, std::size_t digits) {
+    std::string s = std::to_string(value);
+    if (s.size() < digits)
+        s.insert(0, digits - s.size(), '0');
+    return s;
+}
+
+std::string expand_naive(const std::string& pattern, const TemplateTime& t) {
+    std::string name = pattern;
+    const std::pair<const char*, std::string> fields[] = {
+        {"$Y", pad(t.year, 4)}, {"$M", pad(t.month, 2)}, {"$D", pad(t.day, 2)},
+        {"$d", pad(t.day_of_year, 3)}, {"$h", pad(t.hour, 2)}, {"$m", pad(t.minute, 2)},
+        {"$s", pad(t.second, 2)},
+    };
+    for (const auto& [token, value] : fields)
+        for (auto pos = name.find(token); pos != std::string::npos; pos = name.find(token, pos + value.size()))
+            name.replace(pos, 2, value);
+    return name;
+}
+
+TemplateTime step_time(std::size_t step) {
+    const auto s = static_cast<int>(step);
+    return {.year = 1 + s / 31'536'000, .month = 1 + (s / 2'592'000) % 12, .day = 1 + (s / 86'400) % 28,
+            .day_of_year = 1 + (s / 86'400) % 365, .hour = (s / 3600) % 24, .minute = (s / 60) % 60,
+            .second = s % 60};
+}
+
+template<typename F>
+double ns_per_call(std::size_t count, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        f(i);
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           static_cast<double>(count);
+}
+
+} // namespace
+
+int main() {
+    const std::string pattern = "history.$Y-$M-$D_$h.$m.$s.nc";
+    const FilenameTemplate compiled{pattern};
+    std::string buffer(compiled.max_expanded_size(), '\0');
+
+    std::printf("%12s %16s %16s\n", "expansions", "compiled ns", "replace ns");
+    for (std::size_t count = 10'000; count <= 10'000'000; count *= 10) {
+        std::size_t checksum = 0;
+        const double fast = ns_per_call(count, [&](std::size_t i) {
+            checksum += compiled.expand(std::span{buffer}, step_time(i)).size();
+        });
+        const double naive = ns_per_call(count, [&](std::size_t i) {
+            checksum += expand_naive(pattern, step_time(i)).size();
+        });
+        std::printf("%12zu %16.1f %16.1f\n", count, fast, naive);
+        if (checksum == 0)
+            return 1;
+    }
+    return 0;
+}
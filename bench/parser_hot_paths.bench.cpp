@@ -0,0 +1,225 @@
+// Times the parser's hot paths on synthetic streams.xml documents:
+//
+//   traversal   PugiXmlAdapter child iteration and attribute reads
+//   fields      parse_fields
+//   fname_int   parse_filename_interval (through a StreamIndex)
+//   stream      Stream::load_from_xml (through a StreamIndex)
+//   end_to_end  pugixml parse of the text plus StreamSet::load_from_xml
+//   streaming   StreamTable pull parse of the text plus StreamSet::load_from_xml
+//
+// Each stage is run once untimed to warm caches, then repeated until it has
+// run for at least 100 ms. It reports the fastest iteration's ns/stream and
+// the mean heap allocations/stream per iteration. Peak RSS is printed once
+// per document. Usage:
+//
+//   bench_parser_hot_paths [streams [reference_density [immutable_share]]]
+//
+// With no arguments a default sweep over stream counts is run. Reference
+// density is the fraction of streams whose output_interval is a
+// `stream:` reference; immutable share is the fraction written as
+// <immutable_stream>.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "xml_stream_parser.hpp"
+
+using namespace xml_stream_parser;
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+} // namespace
+
+// Counting replacements for the global allocator. Kept out of line so GCC
+// does not pair the inlined malloc/free and warn about a new/delete mismatch.
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct GeneratorOptions {
+    std::size_t streams{1000};
+    double reference_density{0.5};
+    double immutable_share{0.1};
+};
+
+/// Deterministic synthetic document. References always target a stream with
+/// a final interval, so the document loads under strict and chained rules.
+std::string make_streams_xml(const GeneratorOptions& options) {
+    std::mt19937_64 rng{42};
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+    std::vector<std::size_t> final_streams;
+
+    std::string xml = "<streams>\n";
+    for (std::size_t i = 0; i < options.streams; ++i) {
+        const bool immutable = unit(rng) < options.immutable_share;
+        const bool reference = !final_streams.empty() && unit(rng) < options.reference_density;
+        const char* tag = immutable ? "immutable_stream" : "stream";
+
+        std::string output_interval;
+        if (reference) {
+            const auto target = final_streams[rng() % final_streams.size()];
+            output_interval = "stream:s" + std::to_string(target) + ":output_interval";
+        } else {
+            output_interval = std::to_string(1 + i % 24) + ":00:00";
+            final_streams.push_back(i);
+        }
+
+        xml += std::string{"<"} + tag + " name=\"s" + std::to_string(i) +
+               "\" type=\"input output\" filename_template=\"out/s" + std::to_string(i) +
+               ".$Y-$M-$D_$h.nc\" input_interval=\"initial_only\" output_interval=\"" +
+               output_interval + "\" reference_time=\"0001-01-01_00:00:00\" precision=\"double\""
+               " io_type=\"netcdf4\" clobber_mode=\"truncate\"/>\n";
+    }
+    xml += "</streams>\n";
+    return xml;
+}
+
+struct StageResult {
+    double ns_per_stream;
+    double allocations_per_stream;
+};
+
+constexpr std::chrono::milliseconds MIN_STAGE_TIME{100};
+
+template<typename F>
+StageResult measure(std::size_t streams, F&& f) {
+    using clock = std::chrono::steady_clock;
+    f();
+
+    const auto allocations_before = allocations.load(std::memory_order_relaxed);
+    clock::duration total{};
+    clock::duration fastest = clock::duration::max();
+    std::size_t iterations = 0;
+    while (total < MIN_STAGE_TIME) {
+        const auto start = clock::now();
+        f();
+        const auto elapsed = clock::now() - start;
+        total += elapsed;
+        fastest = std::min(fastest, elapsed);
+        ++iterations;
+    }
+    const auto allocated = allocations.load(std::memory_order_relaxed) - allocations_before;
+    const auto n = static_cast<double>(streams);
+    return {std::chrono::duration<double, std::nano>(fastest).count() / n,
+            static_cast<double>(allocated) / static_cast<double>(iterations) / n};
+}
+
+long peak_rss_kib() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template<typename F>
+void for_each_stream(const PugiXmlAdapter& root, F&& f) {
+    for (const auto* tag : {"immutable_stream", "stream"})
+        for (const auto& node : root.children(tag))
+            f(node);
+}
+
+void run(const GeneratorOptions& options) {
+    const std::string xml = make_streams_xml(options);
+    const auto n = options.streams;
+
+    pugi::xml_document doc;
+    doc.load_string(xml.c_str());
+    const PugiXmlAdapter root{doc.child("streams")};
+
+    StreamIndex<PugiXmlAdapter> index;
+    index.build(root);
+
+    std::size_t sink = 0;
+    const auto traversal = measure(n, [&] {
+        for_each_stream(root, [&](const auto& node) {
+            for (const auto& [key, value] : node.get_attributes())
+                sink += key.size() + value.size();
+        });
+    });
+    const auto fields = measure(n, [&] {
+        for_each_stream(root, [&](const auto& node) { sink += parse_fields(node).size(); });
+    });
+    const auto filename_interval = measure(n, [&] {
+        for_each_stream(root, [&](const auto& node) {
+            sink += parse_filename_interval(node.get_attribute("type"),
+                                            node.get_attribute("input_interval"),
+                                            node.get_attribute("output_interval"),
+                                            node.get_attribute("filename_interval"),
+                                            node.get_attribute("name"), index).size();
+        });
+    });
+    const auto stream = measure(n, [&] {
+        for_each_stream(root, [&](const auto& node) {
+            Stream<PugiXmlAdapter> s;
+            s.load_from_xml(node, index);
+            sink += s.get_filename_interval().size();
+        });
+    });
+    const auto end_to_end = measure(n, [&] {
+        pugi::xml_document fresh;
+        fresh.load_string(xml.c_str());
+        StreamSet<PugiXmlAdapter> set;
+        set.load_from_xml(PugiXmlAdapter{fresh.child("streams")});
+        sink += set.size();
+    });
+    const auto streaming = measure(n, [&] {
+        const StreamTable table{xml};
+        StreamSet<StreamTable::Node> set;
+        set.load_from_xml(table.root());
+        sink += set.size();
+    });
+
+    std::printf("%9zu %6.2f %6.2f |", n, options.reference_density, options.immutable_share);
+    for (const auto& r : {traversal, fields, filename_interval, stream, end_to_end, streaming})
+        std::printf(" %9.1f %6.1f |", r.ns_per_stream, r.allocations_per_stream);
+    std::printf(" %9ld\n", peak_rss_kib());
+
+    if (sink == 0)
+        std::exit(1);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::printf("%9s %6s %6s | %16s | %16s | %16s | %16s | %16s | %16s | %9s\n",
+                "streams", "refs", "immut", "traversal", "fields", "fname_int", "stream",
+                "end_to_end", "streaming", "peak KiB");
+    std::printf("%23s |", "");
+    for (int i = 0; i < 6; ++i)
+        std::printf(" %9s %6s |", "ns/strm", "alloc");
+    std::printf("\n");
+
+    if (argc > 1) {
+        GeneratorOptions options{.streams = std::strtoul(argv[1], nullptr, 10)};
+        if (argc > 2) options.reference_density = std::strtod(argv[2], nullptr);
+        if (argc > 3) options.immutable_share   = std::strtod(argv[3], nullptr);
+        if (options.streams == 0) {
+            std::fprintf(stderr, "stream count must be positive\n");
+            return 1;
+        }
+        run(options);
+        return 0;
+    }
+
+    for (std::size_t streams = 100; streams <= 100'000; streams *= 10)
+        run({.streams = streams});
+    return 0;
+}
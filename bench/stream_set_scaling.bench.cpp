@@ -0,0 +1,73 @@
+// Compares whole-document loading through StreamSet (hashed name index)
+// against the per-stream loop over the document root (linear scan for every
+// `stream:` reference). StreamSet cost per stream should stay flat from 10 to
+// 100k streams while the per-stream loop grows with the document size. The
+// parallel column loads the same document with LoadOptions::parallel.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "xml_stream_parser.hpp"
+
+using namespace xml_stream_parser;
+
+namespace {
+
+/// Every stream references the output interval of the last one, which is the
+/// worst case for the per-stream scan and a single hop for both strategies.
+std::string make_streams_xml(std::size_t count) {
+    const std::string target = "s" + std::to_string(count - 1);
+    std::string xml = "<streams>\n";
+    for (std::size_t i = 0; i + 1 < count; ++i)
+        xml += "<stream name=\"s" + std::to_string(i) +
+               "\" type=\"output\" output_interval=\"stream:" + target + ":output_interval\"/>\n";
+    xml += "<stream name=\"" + target + "\" type=\"output\" output_interval=\"6:00:00\"/>\n";
+    xml += "</streams>\n";
+    return xml;
+}
+
+template<typename F>
+double ns_per_stream(std::size_t count, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           static_cast<double>(count);
+}
+
+} // namespace
+
+int main() {
+    // The per-stream loop is quadratic; stop timing it past this size.
+    constexpr std::size_t max_scan_count = 10'000;
+
+    std::printf("%10s %18s %18s %18s\n", "streams", "StreamSet ns/strm", "parallel ns/strm", "scan ns/strm");
+    for (std::size_t count = 10; count <= 100'000; count *= 10) {
+        const std::string xml = make_streams_xml(count);
+        pugi::xml_document doc;
+        doc.load_string(xml.c_str());
+        const PugiXmlAdapter root{doc.child("streams")};
+
+        StreamSet<PugiXmlAdapter> set;
+        const double indexed = ns_per_stream(count, [&] { set.load_from_xml(root); });
+        const double parallel = ns_per_stream(count, [&] {
+            set.load_from_xml(root, LoadOptions{.parallel = true});
+        });
+
+        if (count <= max_scan_count) {
+            const double scanned = ns_per_stream(count, [&] {
+                for (const auto& tag : {"immutable_stream", "stream"}) {
+                    for (const auto& stream_xml : root.children(tag)) {
+                        Stream<PugiXmlAdapter> stream;
+                        stream.load_from_xml(stream_xml, root);
+                    }
+                }
+            });
+            std::printf("%10zu %18.1f %18.1f %18.1f\n", count, indexed, parallel, scanned);
+        } else {
+            std::printf("%10zu %18.1f %18.1f %18s\n", count, indexed, parallel, "-");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Compares reading the streams of a generated streams.xml with pugixml
+// against StreamTable, whose pull tokenizer is run at every SIMD level the
+// CPU supports. Documents carry a <var> list per stream, as generated MPAS
+// streams files do, so most of the bytes are content the table skips.
+// Reports MB/s of document text; the checksum guards against dead-code
+// elimination. Usage:
+//
+//   bench_xml_tokenizer [streams [vars_per_stream]]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <string>
+
+#include "xml_stream_parser.hpp"
+
+using namespace xml_stream_parser;
+
+namespace {
+
+std::string generate(std::size_t streams, std::size_t vars) {
+    std::string xml = "<?xml version=\"1.0\"?>\n<streams>\n";
+    for (std::size_t s = 0; s < streams; ++s) {
+        xml += std::format("    <stream name=\"stream_{}\"\n"
+                           "            type=\"output\"\n"
+                           "            filename_template=\"output/stream_{}.$Y-$M-$D_$h.$m.$s.nc\"\n"
+                           "            output_interval=\"{}\"\n"
+                           "            precision=\"single\">\n",
+                           s, s, s == 0 ? "6:00:00" : "stream:stream_0:output_interval");
+        for (std::size_t v = 0; v < vars; ++v)
+            xml += std::format("        <var name=\"model_variable_{}\"/>\n", v);
+        xml += "    </stream>\n";
+    }
+    xml += "</streams>\n";
+    return xml;
+}
+
+template<typename F>
+double megabytes_per_second(const std::string& xml, F&& f) {
+    const auto repeats = std::max<std::size_t>(1, 64'000'000 / xml.size());
+    const auto start   = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < repeats; ++i)
+        f();
+    const auto stop = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    return static_cast<double>(xml.size() * repeats) / seconds / 1e6;
+}
+
+void run(std::size_t streams, std::size_t vars) {
+    const auto xml = generate(streams, vars);
+    std::size_t checksum = 0;
+
+    const double pugi = megabytes_per_second(xml, [&] {
+        pugi::xml_document doc;
+        doc.load_buffer(xml.data(), xml.size());
+        StreamSet<PugiXmlViewAdapter> set;
+        set.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+        checksum += set.size();
+    });
+
+    double table[3] = {0, 0, 0};
+    for (const auto level : {SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2}) {
+        if (level > supported_simd_level())
+            continue;
+        set_simd_level(level);
+        table[static_cast<int>(level)] = megabytes_per_second(xml, [&] {
+            const StreamTable t{xml};
+            StreamSet<StreamTable::Node> set;
+            set.load_from_xml(t.root());
+            checksum += set.size();
+        });
+    }
+    set_simd_level(supported_simd_level());
+
+    std::printf("%9zu %6zu %10zu | %10.1f | %10.1f %10.1f %10.1f\n",
+                streams, vars, xml.size() / 1024, pugi, table[0], table[1], table[2]);
+    if (checksum == 0)
+        std::exit(1);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::printf("%9s %6s %10s | %10s | %10s %10s %10s\n",
+                "streams", "vars", "KiB", "pugixml", "scalar", "sse2", "avx2");
+    std::printf("%28s | %10s | %32s\n", "", "MB/s", "StreamTable MB/s");
+
+    if (argc > 1) {
+        const auto streams = std::strtoul(argv[1], nullptr, 10);
+        const auto vars    = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+        if (streams == 0) {
+            std::fprintf(stderr, "stream count must be positive\n");
+            return 1;
+        }
+        run(streams, vars);
+        return 0;
+    }
+
+    for (const std::size_t vars : {0, 20, 200})
+        for (std::size_t streams = 10; streams <= 10'000; streams *= 10)
+            run(streams, vars);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_ALLOCATION_HOOKS_HPP
+#define XML_STREAM_PARSER_ALLOCATION_HOOKS_HPP
+
+/**
+ * Replaces the global `operator new` / `operator delete` with versions that
+ * count allocations for load instrumentation.
+ *
+ * Include in exactly one translation unit of a program built with
+ * `XML_STREAM_PARSER_INSTRUMENTATION`; the definitions are not inline.
+ * Without instrumentation this header defines nothing.
+ */
+
+#include "instrumentation.hpp"
+
+#ifdef XML_STREAM_PARSER_INSTRUMENTATION
+
+#include <cstdlib>
+#include <new>
+
+namespace xml_stream_parser::detail {
+
+[[gnu::noinline]] inline void* counted_allocate(std::size_t size) {
+    ++thread_allocations.allocations;
+    thread_allocations.bytes += size;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+} // namespace xml_stream_parser::detail
+
+// Out of line so GCC does not pair the inlined malloc/free and warn about a
+// new/delete mismatch.
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    return xml_stream_parser::detail::counted_allocate(size);
+}
+[[gnu::noinline]] void* operator new[](std::size_t size) {
+    return xml_stream_parser::detail::counted_allocate(size);
+}
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#endif // XML_STREAM_PARSER_INSTRUMENTATION
+
+#endif // XML_STREAM_PARSER_ALLOCATION_HOOKS_HPP
@@ -0,0 +1,491 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_EMBEDDED_STREAMS_HPP
+#define XML_STREAM_PARSER_EMBEDDED_STREAMS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "interval.hpp"
+#include "interval_resolver.hpp"
+#include "parse.hpp"
+#include "stream.hpp"
+#include "stream_attributes.hpp"
+#include "stream_members.hpp"
+#include "stream_set.hpp"
+
+namespace xml_stream_parser {
+
+namespace detail {
+
+/**
+ * Reports a malformed embedded document. Not `constexpr`: reaching it while
+ * a document is parsed at compile time stops compilation, and the compiler
+ * shows the message and offset in its diagnostic.
+ */
+[[noreturn]] inline void embedded_xml_error(const char* message, std::size_t offset) {
+    throw std::runtime_error(std::format("Malformed embedded streams XML at offset {}: {}", offset, message));
+}
+
+/// A start tag reported by `scan_embedded_xml`.
+struct EmbeddedTag {
+    std::string_view name;
+
+    /// Raw text between the name and the closing `>` or `/>`.
+    std::string_view attributes;
+
+    /// Offset of the attribute text in the document, for error messages.
+    std::size_t offset;
+
+    /// 1 for the root element.
+    std::size_t depth;
+};
+
+constexpr bool is_xml_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * Calls `on_tag(tag)` for every start tag of `xml`, in document order.
+ * Comments, processing instructions, CDATA and `<!DOCTYPE ...>` are skipped;
+ * text is ignored. End tags must match their start tags and there must be
+ * exactly one root element.
+ */
+template<typename F>
+constexpr void scan_embedded_xml(std::string_view xml, F&& on_tag) {
+    constexpr std::size_t max_depth = 16;
+    std::array<std::string_view, max_depth> open{};
+    std::size_t depth = 0;
+    bool have_root = false;
+
+    auto skip_past = [&](std::size_t from, std::string_view terminator, const char* message) {
+        const auto end = xml.find(terminator, from);
+        if (end == std::string_view::npos)
+            embedded_xml_error(message, from);
+        return end + terminator.size();
+    };
+
+    for (std::size_t pos = xml.find('<'); pos != std::string_view::npos; pos = xml.find('<', pos)) {
+        const auto rest = xml.substr(pos);
+        if (rest.starts_with("<!--")) {
+            pos = skip_past(pos + 4, "-->", "unterminated comment");
+        } else if (rest.starts_with("<![CDATA[")) {
+            pos = skip_past(pos + 9, "]]>", "unterminated CDATA section");
+        } else if (rest.starts_with("<?")) {
+            pos = skip_past(pos + 2, "?>", "unterminated processing instruction");
+        } else if (rest.starts_with("<!")) {
+            std::size_t i = pos + 2;
+            for (int brackets = 0; i < xml.size() && (xml[i] != '>' || brackets != 0); ++i)
+                brackets += xml[i] == '[' ? 1 : xml[i] == ']' ? -1 : 0;
+            if (i == xml.size())
+                embedded_xml_error("unterminated declaration", pos);
+            pos = i + 1;
+        } else if (rest.starts_with("</")) {
+            const auto gt = xml.find('>', pos);
+            if (gt == std::string_view::npos)
+                embedded_xml_error("unterminated end tag", pos);
+            auto name = xml.substr(pos + 2, gt - pos - 2);
+            while (!name.empty() && is_xml_space(name.back()))
+                name.remove_suffix(1);
+            if (depth == 0 || open[depth - 1] != name)
+                embedded_xml_error("mismatched end tag", pos);
+            --depth;
+            pos = gt + 1;
+        } else {
+            auto name_end = pos + 1;
+            while (name_end < xml.size() && !is_xml_space(xml[name_end]) && xml[name_end] != '/' && xml[name_end] != '>')
+                ++name_end;
+            if (name_end == pos + 1)
+                embedded_xml_error("missing element name", pos);
+
+            auto end = name_end;
+            for (char quote = 0; end < xml.size() && (quote != 0 || xml[end] != '>'); ++end) {
+                if (quote == 0 && (xml[end] == '"' || xml[end] == '\''))
+                    quote = xml[end];
+                else if (xml[end] == quote)
+                    quote = 0;
+            }
+            if (end == xml.size())
+                embedded_xml_error("unterminated start tag", pos);
+
+            const bool self_closing = xml[end - 1] == '/' && end - 1 >= name_end;
+            if (depth == 0 && have_root)
+                embedded_xml_error("more than one root element", pos);
+            have_root = true;
+
+            const auto name = xml.substr(pos + 1, name_end - pos - 1);
+            on_tag(EmbeddedTag{name, xml.substr(name_end, end - name_end - (self_closing ? 1 : 0)), name_end, depth + 1});
+            if (!self_closing) {
+                if (depth == max_depth)
+                    embedded_xml_error("elements nested too deeply", pos);
+                open[depth++] = name;
+            }
+            pos = end + 1;
+        }
+    }
+
+    if (depth != 0)
+        embedded_xml_error("unclosed element", xml.size());
+    if (!have_root)
+        embedded_xml_error("no root element", 0);
+}
+
+/**
+ * Calls `f(key, value)` for every attribute of a tag scanned by
+ * `scan_embedded_xml`. Values are used verbatim, so values that an XML
+ * parser would rewrite (entity references, tabs and line breaks) are
+ * rejected rather than silently differing from a runtime load.
+ */
+template<typename F>
+constexpr void for_each_embedded_attribute(const EmbeddedTag& tag, F&& f) {
+    const auto text = tag.attributes;
+    std::size_t pos = 0;
+    auto skip_space = [&] {
+        while (pos < text.size() && is_xml_space(text[pos]))
+            ++pos;
+    };
+
+    for (skip_space(); pos < text.size(); skip_space()) {
+        const auto key_begin = pos;
+        while (pos < text.size() && !is_xml_space(text[pos]) && text[pos] != '=')
+            ++pos;
+        const auto key = text.substr(key_begin, pos - key_begin);
+        skip_space();
+        if (key.empty() || pos == text.size() || text[pos] != '=')
+            embedded_xml_error("expected attribute '='", tag.offset + pos);
+        ++pos;
+        skip_space();
+        if (pos == text.size() || (text[pos] != '"' && text[pos] != '\''))
+            embedded_xml_error("expected quoted attribute value", tag.offset + pos);
+        const auto close = text.find(text[pos], pos + 1);
+        if (close == std::string_view::npos)
+            embedded_xml_error("unterminated attribute value", tag.offset + pos);
+        const auto value = text.substr(pos + 1, close - pos - 1);
+        for (const char c : value)
+            if (c == '&' || c == '<' || c == '\t' || c == '\r' || c == '\n')
+                embedded_xml_error("attribute value needs decoding; embedded values must be literal", tag.offset + pos);
+        f(key, value);
+        pos = close + 1;
+    }
+}
+
+constexpr std::optional<MemberKind> classify_member(std::string_view tag) noexcept {
+    for (const auto kind : MEMBER_KINDS)
+        if (to_string(kind) == tag)
+            return kind;
+    return std::nullopt;
+}
+
+constexpr bool is_stream_tag(std::string_view tag) noexcept {
+    return tag == "immutable_stream" || tag == "stream";
+}
+
+/// The `name` attribute of a tag, if it has one.
+constexpr std::optional<std::string_view> embedded_name(const EmbeddedTag& tag) {
+    std::optional<std::string_view> name;
+    for_each_embedded_attribute(tag, [&](std::string_view key, std::string_view value) {
+        if (key == "name" && !name)
+            name = value;
+    });
+    return name;
+}
+
+} // namespace detail
+
+/**
+ * @brief Storage an embedded streams document needs; see `EmbeddedStreams`.
+ */
+struct EmbeddedStreamsSize {
+    /// `<immutable_stream>` and `<stream>` elements with a `name` attribute.
+    std::size_t streams{0};
+
+    /// Bytes of the streams' encoded member lists.
+    std::size_t member_bytes{0};
+};
+
+/**
+ * @brief Measures an embedded streams document, at compile time or at run time.
+ * @throws std::runtime_error if the document is not well-formed.
+ */
+constexpr EmbeddedStreamsSize measure_embedded_streams(std::string_view xml) {
+    EmbeddedStreamsSize size;
+    bool in_stream = false;
+    detail::scan_embedded_xml(xml, [&](const detail::EmbeddedTag& tag) {
+        if (tag.depth == 2) {
+            in_stream = detail::is_stream_tag(tag.name) && detail::embedded_name(tag).has_value();
+            size.streams += in_stream ? 1 : 0;
+        } else if (tag.depth == 3 && in_stream && detail::classify_member(tag.name)) {
+            size.member_bytes += detail::embedded_name(tag).value_or("").size() + 2;
+        }
+    });
+    return size;
+}
+
+/**
+ * @class EmbeddedStreams
+ * @brief Streams resolved from a streams.xml document compiled into the binary.
+ *
+ * Construction performs everything `StreamSet::load_from_xml` does (attribute
+ * parsing, enum conversion, `stream:` interval resolution with the same
+ * rules and errors as `IntervalResolver`, filename interval selection,
+ * interval validation and member collection) but is `constexpr`. Declared
+ * `constexpr`, a configuration error fails the build and nothing is
+ * parsed at run time:
+ *
+ * @code
+ * static constexpr std::string_view STREAMS_XML = R"(<streams>...</streams>)";
+ * constexpr auto STREAMS = embed_streams<STREAMS_XML>();
+ * static_assert(STREAMS.find("history")->type == 2);
+ * @endcode
+ *
+ * A file can be embedded with `#embed` where the compiler supports it, as a
+ * `static constexpr char[]` viewed by the `std::string_view`.
+ *
+ * Values are `StreamValues` viewing the document text, which must therefore
+ * have static storage duration; member lists view the object itself. Since
+ * views cannot hold decoded text, attribute values must be literal: a value
+ * with an entity reference, tab or line break is rejected. The document is
+ * read by a small scanner for the subset of XML that stream definitions use.
+ *
+ * @tparam Streams     Number of named streams; see `measure_embedded_streams`.
+ * @tparam MemberBytes Size of the encoded member lists; see `measure_embedded_streams`.
+ */
+template<std::size_t Streams, std::size_t MemberBytes>
+class EmbeddedStreams {
+public:
+    /**
+     * @brief Resolves every stream of `xml`.
+     * @param xml     The document; must outlive the object.
+     * @param options Interval resolution rules, as for `StreamSet`.
+     * @throws std::runtime_error, StreamIntervalError on the errors a runtime
+     *         load would report; in a constant expression these fail compilation.
+     */
+    constexpr explicit EmbeddedStreams(std::string_view xml, IntervalResolverOptions options = {}) {
+        std::vector<RawStream> raw;
+        std::vector<StreamMember> members;
+
+        // Immutable streams first, each tag in document order, as `StreamIndex` does.
+        for (const std::string_view wanted : {"immutable_stream", "stream"}) {
+            bool in_stream = false;
+            detail::scan_embedded_xml(xml, [&](const detail::EmbeddedTag& tag) {
+                if (tag.depth == 1) {
+                    if (tag.name != "streams")
+                        detail::embedded_xml_error("root element is not <streams>", 0);
+                } else if (tag.depth == 2) {
+                    in_stream = tag.name == wanted && detail::embedded_name(tag).has_value();
+                    if (in_stream)
+                        raw.push_back(read_stream(tag, members.size()));
+                } else if (tag.depth == 3 && in_stream) {
+                    if (const auto kind = detail::classify_member(tag.name)) {
+                        const auto name = detail::embedded_name(tag).value_or("");
+                        if (name.empty())
+                            throw std::runtime_error(std::format(
+                                "Stream '{}' has a <{}> element without a name",
+                                raw.back().fields[0], to_string(*kind)));
+                        members.push_back({*kind, name});
+                        raw.back().members_end = members.size();
+                    }
+                }
+            });
+        }
+        if (raw.size() != Streams)
+            detail::embedded_xml_error("stream count differs from the measured size", 0);
+
+        std::size_t text = 0;
+        for (std::size_t i = 0; i < Streams; ++i) {
+            m_values[i] = resolve(raw, i, options);
+            m_members[i].first = text;
+            for (const auto kind : MEMBER_KINDS) {
+                for (auto m = raw[i].members_begin; m < raw[i].members_end; ++m) {
+                    if (members[m].kind != kind)
+                        continue;
+                    if (text + members[m].name.size() + 2 > MemberBytes)
+                        detail::embedded_xml_error("member list size differs from the measured size", 0);
+                    m_member_text[text++] = static_cast<char>('0' + static_cast<int>(kind));
+                    for (const char c : members[m].name)
+                        m_member_text[text++] = c;
+                    m_member_text[text++] = '\0';
+                }
+            }
+            m_members[i].second = text;
+        }
+    }
+
+    /** @return The number of streams, immutable streams first, in document order. */
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return Streams; }
+
+    /** @return The values of the i-th stream. */
+    [[nodiscard]] constexpr StreamValues operator[](std::size_t i) const noexcept {
+        auto values = m_values[i];
+        const auto [first, last] = m_members[i];
+        values.members = std::string_view{m_member_text.data() + first, last - first};
+        return values;
+    }
+
+    /** @return The first stream with the given name, immutable streams first, or std::nullopt. */
+    [[nodiscard]] constexpr std::optional<StreamValues> find(std::string_view name) const noexcept {
+        for (std::size_t i = 0; i < Streams; ++i)
+            if (m_values[i].stream_id == name)
+                return (*this)[i];
+        return std::nullopt;
+    }
+
+private:
+    using enum StreamAttribute;
+
+    /// A stream element's attributes before resolution.
+    struct RawStream {
+        std::array<std::string_view, STREAM_ATTRIBUTE_COUNT> fields{};
+        std::uint16_t present{0};
+        bool immutable{false};
+        std::size_t members_begin{0};
+        std::size_t members_end{0};
+
+        [[nodiscard]] constexpr std::string_view operator[](StreamAttribute attr) const noexcept {
+            return fields[static_cast<std::size_t>(attr)];
+        }
+
+        [[nodiscard]] constexpr bool contains(std::string_view attr) const noexcept {
+            const auto known = classify_stream_attribute(attr);
+            return known && ((present >> static_cast<std::size_t>(*known)) & 1u);
+        }
+    };
+
+    static constexpr RawStream read_stream(const detail::EmbeddedTag& tag, std::size_t members) {
+        RawStream stream;
+        stream.immutable     = tag.name == "immutable_stream";
+        stream.members_begin = members;
+        stream.members_end   = members;
+        detail::for_each_embedded_attribute(tag, [&](std::string_view key, std::string_view value) {
+            if (const auto attr = classify_stream_attribute(key)) {
+                const auto i = static_cast<std::size_t>(*attr);
+                stream.fields[i] = value;
+                stream.present |= static_cast<std::uint16_t>(1u << i);
+            }
+        });
+        return stream;
+    }
+
+    /// The values `BasicStream::load_from_xml` would produce for `raw[i]`.
+    static constexpr StreamValues resolve(const std::vector<RawStream>& raw,
+                                          std::size_t i,
+                                          const IntervalResolverOptions& options) {
+        const auto& stream = raw[i];
+        StreamValues values;
+        values.stream_id         = stream[name];
+        values.type              = parse_direction(stream[type]);
+        values.reference_time    = parse_reference_time(stream[reference_time]);
+        values.record_interval   = parse_record_interval(stream[record_interval]);
+        values.precision         = parse_precision_bytes(stream[precision]);
+        values.iotype            = parse_io_type(stream[io_type]);
+        values.immutable         = stream.immutable ? 1 : 0;
+        values.clobber_mode      = parse_clobber_mode(stream[clobber_mode]);
+        values.input_interval    = follow(raw, stream[input_interval], "input_interval", values.stream_id, options);
+        values.output_interval   = follow(raw, stream[output_interval], "output_interval", values.stream_id, options);
+        values.filename_interval = select_filename_interval(
+            stream[type], values.input_interval, values.output_interval, stream[filename_interval]);
+        values.filename_template = stream[filename_template];
+
+        // Derived filename intervals are checked last, so errors name their source.
+        parse_stream_interval(values.record_interval, "record_interval", values.stream_id);
+        parse_stream_interval(values.input_interval, "input_interval", values.stream_id);
+        parse_stream_interval(values.output_interval, "output_interval", values.stream_id);
+        parse_stream_interval(values.filename_interval, "filename_interval", values.stream_id);
+        return values;
+    }
+
+    /// `IntervalResolver::resolve` over the raw streams, without the memo.
+    /// Must mirror `IntervalResolver::follow`: the same checks, in the same
+    /// order, with the same hop counting, so a document restored here fails
+    /// exactly where a runtime load would.
+    static constexpr std::string_view follow(const std::vector<RawStream>& raw,
+                                             std::string_view value,
+                                             std::string_view interval_type,
+                                             std::string_view stream_id,
+                                             const IntervalResolverOptions& options) {
+        std::vector<std::pair<std::string_view, std::string_view>> chain{{stream_id, interval_type}};
+        while (value.starts_with("stream:")) {
+            const auto target = value.substr(7); // remove "stream:"
+            const auto pos = target.find(':');
+            if (pos == std::string_view::npos)
+                throw StreamIntervalError("Malformed interval reference (missing ':')");
+
+            const auto target_stream = target.substr(0, pos);
+            const auto target_attr   = target.substr(pos + 1);
+            ensure_not_recursive(chain.back().first, chain.back().second, target_stream, target_attr);
+            ensure_valid_attribute(target_attr);
+
+            if (std::ranges::find(chain, std::pair{target_stream, target_attr}) != chain.end())
+                throw StreamIntervalError(std::format(
+                    "Cyclic interval reference through '{}:{}'", target_stream, target_attr));
+
+            const auto found = std::ranges::find(raw, target_stream, [](const RawStream& s) { return s[name]; });
+            if (found == raw.end())
+                throw StreamIntervalError(std::format("Referenced stream '{}' not found", target_stream));
+            if (!found->contains(target_attr))
+                throw StreamIntervalError(std::format(
+                    "Referenced attribute '{}' missing in stream '{}'", target_attr, target_stream));
+
+            value = found->fields[static_cast<std::size_t>(*classify_stream_attribute(target_attr))];
+            if (options.strict || !value.starts_with("stream:")) {
+                ensure_resolved_value_is_final(value);
+                if (!options.strict && chain.size() > options.max_depth)
+                    throw StreamIntervalError(std::format(
+                        "Interval reference chain exceeds {} hops", options.max_depth));
+                break;
+            }
+            if (chain.size() + 1 > options.max_depth)
+                throw StreamIntervalError(std::format(
+                    "Interval reference chain exceeds {} hops", options.max_depth));
+            chain.emplace_back(target_stream, target_attr);
+        }
+        return value;
+    }
+
+    std::array<StreamValues, Streams> m_values{};
+
+    /// Each stream's range of `m_member_text`.
+    std::array<std::pair<std::size_t, std::size_t>, Streams> m_members{};
+
+    std::array<char, MemberBytes> m_member_text{};
+};
+
+/**
+ * @brief Resolves a streams.xml document held in a `static constexpr std::string_view`, at compile time.
+ *
+ * Sizes the result with `measure_embedded_streams`; any configuration error
+ * is a compilation error.
+ */
+template<const std::string_view& Xml, IntervalResolverOptions Options = IntervalResolverOptions{}>
+consteval auto embed_streams() {
+    constexpr auto size = measure_embedded_streams(Xml);
+    return EmbeddedStreams<size.streams, size.member_bytes>{Xml, Options};
+}
+
+/**
+ * @brief Builds a stream set from embedded streams, without parsing any XML.
+ *
+ * Only the filename templates are compiled and the already validated
+ * intervals parsed into `Interval`s, as for a cache restore.
+ */
+template<XmlNodeLike Node, typename Allocator = std::allocator<char>, std::size_t Streams, std::size_t MemberBytes>
+[[nodiscard]] BasicStreamSet<Node, Allocator> restore_stream_set(const EmbeddedStreams<Streams, MemberBytes>& embedded,
+                                                                const Allocator& alloc = Allocator{}) {
+    BasicStreamSet<Node, Allocator> set{alloc};
+    typename BasicStreamSet<Node, Allocator>::container_type streams(embedded.size(), set.get_allocator());
+    for (std::size_t i = 0; i < streams.size(); ++i)
+        streams[i].restore(embedded[i]);
+    set.assign(std::move(streams));
+    return set;
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_EMBEDDED_STREAMS_HPP
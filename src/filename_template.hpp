@@ -0,0 +1,260 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_FILENAME_TEMPLATE_HPP
+#define XML_STREAM_PARSER_FILENAME_TEMPLATE_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "string_pool.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @brief The time fields substituted into a filename template.
+ *
+ * `day_of_year` is supplied by the caller because it depends on the model
+ * calendar (gregorian, noleap, 360_day).
+ */
+struct TemplateTime {
+    int year{0};
+    int month{1};
+    int day{1};
+    int day_of_year{1};
+    int hour{0};
+    int minute{0};
+    int second{0};
+};
+
+/**
+ * @class BasicFilenameTemplate
+ * @brief An MPAS filename template compiled for repeated expansion.
+ *
+ * The template is scanned once into a sequence of literal spans and time
+ * field tokens. Recognized tokens are `$Y` (year, at least 4 digits), `$M`,
+ * `$D`, `$h`, `$m`, `$s` (2 digits) and `$d` (day of year, 3 digits). Any
+ * other `$` sequence is kept literally.
+ *
+ * `expand()` writes into a caller-provided buffer and does not allocate, so
+ * a buffer of `max_expanded_size()` bytes can be reused for every output
+ * step.
+ *
+ * @tparam Allocator Allocator for the stored pattern and segments; see
+ *                   `FilenameTemplate` and `pmr::FilenameTemplate`.
+ */
+template<typename Allocator = std::allocator<char>>
+class BasicFilenameTemplate {
+public:
+    using allocator_type = Allocator;
+    using string_type    = stream_string_t<Allocator>;
+
+    BasicFilenameTemplate() = default;
+
+    explicit BasicFilenameTemplate(const Allocator& alloc) noexcept
+        : m_pattern{alloc}, m_segments{segment_allocator{alloc}} {}
+
+    BasicFilenameTemplate(const BasicFilenameTemplate&) = default;
+    BasicFilenameTemplate(BasicFilenameTemplate&&) noexcept = default;
+    BasicFilenameTemplate& operator=(const BasicFilenameTemplate&) = default;
+    BasicFilenameTemplate& operator=(BasicFilenameTemplate&&) = default;
+
+    BasicFilenameTemplate(const BasicFilenameTemplate& other, const Allocator& alloc)
+        : m_pattern{other.m_pattern, alloc},
+          m_segments{other.m_segments, segment_allocator{alloc}},
+          m_max_size{other.m_max_size} {}
+
+    BasicFilenameTemplate(BasicFilenameTemplate&& other, const Allocator& alloc)
+        : m_pattern{std::move(other.m_pattern), alloc},
+          m_segments{std::move(other.m_segments), segment_allocator{alloc}},
+          m_max_size{other.m_max_size} {}
+
+    /** @param pattern The raw template, e.g. `history.$Y-$M-$D_$h.$m.$s.nc`. */
+    explicit BasicFilenameTemplate(std::string_view pattern, const Allocator& alloc = Allocator{})
+        : m_pattern{pattern, alloc}, m_segments{segment_allocator{alloc}} {
+        std::size_t literal_begin = 0;
+        auto flush_literal = [&](std::size_t end) {
+            if (end > literal_begin)
+                m_segments.push_back({Field::literal,
+                                      static_cast<std::uint32_t>(literal_begin),
+                                      static_cast<std::uint32_t>(end - literal_begin)});
+        };
+
+        for (std::size_t i = 0; i + 1 < m_pattern.size(); ++i) {
+            if (m_pattern[i] != '$')
+                continue;
+            const auto field = classify(m_pattern[i + 1]);
+            if (field == Field::literal)
+                continue;
+            flush_literal(i);
+            m_segments.push_back({field, 0, 0});
+            literal_begin = ++i + 1;
+        }
+        flush_literal(m_pattern.size());
+
+        for (const auto& segment : m_segments)
+            m_max_size += segment.field == Field::literal ? segment.length : MAX_FIELD_WIDTH;
+    }
+
+    /** @return The template as written. */
+    [[nodiscard]] const string_type& pattern() const noexcept { return m_pattern; }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_pattern.get_allocator(); }
+
+    /** @return True if the template contains no time fields. */
+    [[nodiscard]] bool is_constant() const noexcept {
+        return std::ranges::none_of(m_segments, [](const auto& s) { return s.field != Field::literal; });
+    }
+
+    /** @return A buffer size sufficient for any expansion of this template. */
+    [[nodiscard]] std::size_t max_expanded_size() const noexcept { return m_max_size; }
+
+    /**
+     * @brief Expands the template for a time into `buffer`.
+     * @return The expanded name, viewing `buffer`.
+     * @throws std::length_error if `buffer` is too small for the result.
+     */
+    std::string_view expand(std::span<char> buffer, const TemplateTime& time) const {
+        char* out       = buffer.data();
+        char* const end = buffer.data() + buffer.size();
+
+        for (const auto& segment : m_segments) {
+            if (segment.field == Field::literal) {
+                if (static_cast<std::size_t>(end - out) < segment.length)
+                    throw std::length_error(std::format(
+                        "Buffer too small to expand filename template '{}'", std::string_view{m_pattern}));
+                out = std::copy_n(m_pattern.data() + segment.offset, segment.length, out);
+            } else {
+                out = write_field(out, end, segment.field, time);
+            }
+        }
+        return {buffer.data(), static_cast<std::size_t>(out - buffer.data())};
+    }
+
+    /** @return The expanded name as a new string. */
+    [[nodiscard]] std::string expand(const TemplateTime& time) const {
+        std::string result(m_max_size, '\0');
+        result.resize(expand(std::span{result}, time).size());
+        return result;
+    }
+
+    [[nodiscard]] bool operator==(const BasicFilenameTemplate& other) const noexcept {
+        return m_pattern == other.m_pattern;
+    }
+
+private:
+    enum class Field : std::uint8_t { literal, year, month, day, day_of_year, hour, minute, second };
+
+    /// A literal span of `m_pattern`, or a time field (offset and length unused).
+    struct Segment {
+        Field field;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    static constexpr Field classify(char c) noexcept {
+        switch (c) {
+            case 'Y': return Field::year;
+            case 'M': return Field::month;
+            case 'D': return Field::day;
+            case 'd': return Field::day_of_year;
+            case 'h': return Field::hour;
+            case 'm': return Field::minute;
+            case 's': return Field::second;
+            default:  return Field::literal;
+        }
+    }
+
+    /// Characters needed for any int field value, including the sign.
+    static constexpr std::size_t MAX_FIELD_WIDTH = 11;
+
+    /// Minimum number of digits for a field; shorter values are zero-padded.
+    static constexpr int min_digits(Field field) noexcept {
+        switch (field) {
+            case Field::year:        return 4;
+            case Field::day_of_year: return 3;
+            default:                 return 2;
+        }
+    }
+
+    static constexpr int value(Field field, const TemplateTime& t) noexcept {
+        switch (field) {
+            case Field::year:        return t.year;
+            case Field::month:       return t.month;
+            case Field::day:         return t.day;
+            case Field::day_of_year: return t.day_of_year;
+            case Field::hour:        return t.hour;
+            case Field::minute:      return t.minute;
+            case Field::second:      return t.second;
+            case Field::literal:     break;
+        }
+        return 0;
+    }
+
+    char* write_field(char* out, char* end, Field field, const TemplateTime& time) const {
+        const int v      = value(field, time);
+        const int digits = min_digits(field);
+
+        // Common case: a value that fits its padded width exactly.
+        if (v >= 0 && v < (digits == 2 ? 100 : digits == 3 ? 1000 : 10000) && end - out >= digits) {
+            for (int i = digits - 1, rest = v; i >= 0; --i, rest /= 10)
+                out[i] = static_cast<char>('0' + rest % 10);
+            return out + digits;
+        }
+        return write_field_slow(out, end, field, v);
+    }
+
+    char* write_field_slow(char* out, char* end, Field field, int v) const {
+        char digits[16];
+        const char* const last =
+            std::to_chars(std::begin(digits), std::end(digits), v).ptr;
+        const char* first = digits;
+
+        std::size_t count = static_cast<std::size_t>(last - first);
+        const bool negative = *first == '-';
+        const auto magnitude = count - (negative ? 1 : 0);
+        const auto pad = magnitude < static_cast<std::size_t>(min_digits(field))
+                             ? static_cast<std::size_t>(min_digits(field)) - magnitude : 0;
+
+        if (static_cast<std::size_t>(end - out) < count + pad)
+            throw std::length_error(std::format(
+                "Buffer too small to expand filename template '{}'", std::string_view{m_pattern}));
+
+        if (negative) {
+            *out++ = '-';
+            ++first;
+            --count;
+        }
+        out = std::fill_n(out, pad, '0');
+        return std::copy_n(first, count, out);
+    }
+
+    using segment_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Segment>;
+
+    string_type m_pattern;
+    std::vector<Segment, segment_allocator> m_segments;
+    std::size_t m_max_size{0};
+};
+
+/// Filename template using the default allocator.
+using FilenameTemplate = BasicFilenameTemplate<>;
+
+namespace pmr {
+
+/// Filename template allocating from a `std::pmr::memory_resource`.
+using FilenameTemplate = BasicFilenameTemplate<std::pmr::polymorphic_allocator<char>>;
+
+} // namespace pmr
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_FILENAME_TEMPLATE_HPP
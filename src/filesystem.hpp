@@ -2,9 +2,21 @@
 #ifndef XML_STREAM_PARSER_FILESYSTEM_HPP
 #define XML_STREAM_PARSER_FILESYSTEM_HPP
 
-#include <string>
+#include <cerrno>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <system_error>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace xml_stream_parser {
 
@@ -16,6 +28,15 @@ namespace fs = std::filesystem;
  * @{
  */
 
+/**
+ * @brief Outcome of `IXmlFileSystem::ensure_writable_directory`.
+ */
+enum class DirectoryStatus {
+    writable,      ///< The directory exists (or was created) and is writable.
+    create_failed, ///< The directory did not exist and could not be created.
+    not_writable,  ///< The path exists but is not a directory the caller may write to.
+};
+
 /**
  * @class IXmlFileSystem
  * @brief Interface for filesystem operations used by the XML stream parser.
@@ -27,9 +48,13 @@ namespace fs = std::filesystem;
  *   - Existence checks
  *   - Directory creation
  *   - Write-permission checks
+ *   - Reading small text files, such as `<file>` variable lists
+ *
+ * `ensure_writable_directory` combines the first three; implementations may
+ * override it to need fewer system calls.
  *
  * Implementations should never throw exceptions. All methods must return
- * boolean success/failure indicators instead.
+ * boolean success/failure indicators (or an empty optional) instead.
  */
 struct IXmlFileSystem {
     virtual ~IXmlFileSystem() = default;
@@ -54,17 +79,100 @@ struct IXmlFileSystem {
      * @return True on success; false if creation failed.
      */
     virtual bool create_directories(const std::string& path) noexcept = 0;
+
+    /**
+     * @brief Creates the directory if needed and checks that it is writable.
+     *
+     * The default implementation calls `exists`, `create_directories` if the
+     * path is missing, then `can_write`.
+     *
+     * @param path Directory path.
+     */
+    virtual DirectoryStatus ensure_writable_directory(const std::string& path) noexcept {
+        if (!exists(path) && !create_directories(path))
+            return DirectoryStatus::create_failed;
+        return can_write(path) ? DirectoryStatus::writable : DirectoryStatus::not_writable;
+    }
+
+    /**
+     * @brief Reads a whole file into memory.
+     *
+     * The default implementation reads a regular file with one
+     * `std::ifstream` read of its full size. Must be safe to call from
+     * several threads.
+     *
+     * @param path File path.
+     * @return The file's bytes, or std::nullopt if it cannot be read.
+     */
+    [[nodiscard]] virtual std::optional<std::string> read_file(const std::string& path) const {
+        // A directory opens as a stream but has no meaningful size.
+        std::error_code ec;
+        if (!fs::is_regular_file(path, ec))
+            return std::nullopt;
+        std::ifstream in{path, std::ios::binary | std::ios::ate};
+        if (!in)
+            return std::nullopt;
+        const auto size = static_cast<std::streamoff>(in.tellg());
+        if (size < 0)
+            return std::nullopt;
+        std::string contents(static_cast<std::size_t>(size), '\0');
+        if (!in.seekg(0) || !in.read(contents.data(), size))
+            return std::nullopt;
+        return contents;
+    }
 };
 
 /**
- * @class XmlFileSystem
- * @brief Concrete `IXmlFileSystem` implementation using `std::filesystem`.
+ * @brief The system calls `BasicXmlFileSystem` is built on.
+ *
+ * Each returns 0 on success or the `errno` value of the failure. Tests
+ * substitute a type with the same members to count or fake calls.
+ */
+struct PosixFileCalls {
+    /** @brief `mkdir(2)` with mode 0777, leaving permissions to the umask. */
+    int make_directory(const char* path) const noexcept {
+        return ::mkdir(path, 0777) == 0 ? 0 : errno;
+    }
+
+    /** @brief `faccessat(2)` checked against the effective user and group. */
+    int check_access(const char* path, int mode) const noexcept {
+        return ::faccessat(AT_FDCWD, path, mode, AT_EACCESS) == 0 ? 0 : errno;
+    }
+};
+
+/**
+ * @class BasicXmlFileSystem
+ * @brief Concrete `IXmlFileSystem` implementation for production use.
+ *
+ * Writability is decided by `faccessat(W_OK, AT_EACCESS)`, i.e. for the
+ * effective user, ACLs and read-only mounts included. Results can be cached
+ * per path for a fixed time, so that many streams sharing a directory on a
+ * parallel filesystem cost one check. The cache is internally synchronized;
+ * all methods may be called concurrently. Copies share one cache.
  *
- * This class provides filesystem behavior for production use. All methods use
- * `std::error_code` overloads to ensure **no exceptions** are thrown.
+ * All methods use non-throwing APIs and report failure through their return
+ * values.
+ *
+ * @tparam Calls System call layer; see `PosixFileCalls`.
  */
-class XmlFileSystem final : public IXmlFileSystem {
+template<typename Calls = PosixFileCalls>
+class BasicXmlFileSystem final : public IXmlFileSystem {
 public:
+    using clock = std::chrono::steady_clock;
+
+    /** @brief A file system that checks writability on every call. */
+    BasicXmlFileSystem() = default;
+
+    /**
+     * @param writable_ttl How long a writability result is reused for the
+     *                     same path; zero disables the cache.
+     * @param calls        System call layer.
+     */
+    explicit BasicXmlFileSystem(clock::duration writable_ttl, Calls calls = Calls{})
+        : m_calls{std::move(calls)},
+          m_ttl{writable_ttl},
+          m_cache{writable_ttl == clock::duration::zero() ? nullptr : std::make_shared<WritabilityCache>()} {}
+
     /**
      * @brief Checks whether a path exists on disk.
      *
@@ -83,34 +191,128 @@ public:
     bool create_directories(const std::string& path) noexcept override {
         std::error_code ec;
         fs::create_directories(path, ec);
+        forget(path);
         return !ec;
     }
 
     /**
-     * @brief Determines whether the directory at `path` is writable.
+     * @brief Determines whether the current effective user can write to `path`.
      *
-     * Permission logic:
-     *   - Inspects POSIX-style write bits for owner / group / others.
-     *   - If permission bits cannot be retrieved, returns false.
-     *
-     * This is a conservative check: failure to confirm write access results in
-     * a "not writable" outcome to protect against incorrect filesystem use.
+     * Served from the cache when a fresh result for `path` exists. A path
+     * that does not exist yet is not cached, since it may be created next.
      */
     [[nodiscard]] bool can_write(const std::string& path) const noexcept override {
-        std::error_code ec;
-        const auto st = fs::status(path, ec);
-        if (ec) return false;
+        if (const auto cached = lookup(path))
+            return *cached;
+        const int error = m_calls.check_access(path.c_str(), W_OK);
+        if (error != ENOENT && error != ENOTDIR)
+            store(path, error == 0);
+        return error == 0;
+    }
+
+    /**
+     * @brief Creates the directory if needed and checks that it is writable.
+     *
+     * Tries `mkdir` first instead of asking whether the path exists: an
+     * existing directory costs one failed `mkdir` (EEXIST) and one access
+     * check, a new one a `mkdir` per missing level and one access check. A
+     * cached writable result costs nothing; a cached negative one is
+     * rechecked, because creating the directory may be what fixes it.
+     *
+     * Results are cached under `path + '/'`, apart from `can_write(path)`,
+     * which also passes for a writable regular file.
+     */
+    DirectoryStatus ensure_writable_directory(const std::string& path) noexcept override {
+        // A trailing '/' makes the check fail with ENOTDIR if an existing
+        // entry is not a directory.
+        const auto directory = path + '/';
+        if (lookup(directory) == true)
+            return DirectoryStatus::writable;
 
-        const auto perms = st.permissions();
-        constexpr auto write_mask =
-            fs::perms::owner_write |
-            fs::perms::group_write |
-            fs::perms::others_write;
+        const int made = make_directories(path);
+        if (made != 0 && made != EEXIST)
+            return DirectoryStatus::create_failed;
+
+        const bool writable = m_calls.check_access(directory.c_str(), W_OK) == 0;
+        store(directory, writable);
+        // A writable directory answers can_write(path) as well.
+        if (writable)
+            store(path, true);
+        return writable ? DirectoryStatus::writable : DirectoryStatus::not_writable;
+    }
 
-        return (perms & write_mask) != fs::perms::none;
+    /** @brief Forgets every cached writability result. */
+    void clear_cache() noexcept {
+        if (!m_cache)
+            return;
+        const std::scoped_lock lock{m_cache->mutex};
+        m_cache->entries.clear();
     }
+
+    /** @return The system call layer, e.g. to read a test's counters. */
+    [[nodiscard]] const Calls& calls() const noexcept { return m_calls; }
+
+private:
+    struct CacheEntry {
+        bool writable;
+        clock::time_point expires;
+    };
+
+    struct WritabilityCache {
+        std::mutex mutex;
+        std::unordered_map<std::string, CacheEntry> entries;
+    };
+
+    /// `mkdir -p` one level at a time, from the deepest level up only as far as needed.
+    int make_directories(const std::string& path) const noexcept {
+        const int made = m_calls.make_directory(path.c_str());
+        if (made != ENOENT)
+            return made;
+
+        const auto parent = fs::path(path).parent_path();
+        if (parent.empty() || parent == fs::path(path))
+            return made;
+        const int parent_made = make_directories(parent.string());
+        if (parent_made != 0 && parent_made != EEXIST)
+            return parent_made;
+        return m_calls.make_directory(path.c_str());
+    }
+
+    std::optional<bool> lookup(const std::string& path) const noexcept {
+        if (!m_cache)
+            return std::nullopt;
+        const std::scoped_lock lock{m_cache->mutex};
+        if (const auto it = m_cache->entries.find(path);
+            it != m_cache->entries.end() && clock::now() < it->second.expires)
+            return it->second.writable;
+        return std::nullopt;
+    }
+
+    void store(const std::string& path, bool writable) const noexcept {
+        if (!m_cache)
+            return;
+        const std::scoped_lock lock{m_cache->mutex};
+        m_cache->entries.insert_or_assign(path, CacheEntry{writable, clock::now() + m_ttl});
+    }
+
+    void forget(const std::string& path) noexcept {
+        if (!m_cache)
+            return;
+        const std::scoped_lock lock{m_cache->mutex};
+        m_cache->entries.erase(path);
+        m_cache->entries.erase(path + '/');
+    }
+
+    Calls m_calls{};
+    clock::duration m_ttl{clock::duration::zero()};
+
+    /// Null when caching is disabled, so the default file system stays allocation-free.
+    std::shared_ptr<WritabilityCache> m_cache;
 };
 
+/// The production file system, calling the operating system directly.
+using XmlFileSystem = BasicXmlFileSystem<>;
+
 /** @} */ // end of filesystem_backend
 
 } // namespace xml_stream_parser
@@ -0,0 +1,56 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_HASH_HPP
+#define XML_STREAM_PARSER_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace xml_stream_parser {
+
+/// FNV-1a 64-bit offset basis.
+inline constexpr std::uint64_t FNV1A_64_OFFSET_BASIS = 14695981039346656037ull;
+
+/**
+ * @brief 64-bit FNV-1a hash of a byte sequence.
+ * @param bytes Data to hash.
+ * @param hash  Running hash, for hashing several sequences in a row.
+ */
+[[nodiscard]] constexpr std::uint64_t fnv1a_64(std::span<const std::byte> bytes,
+                                               std::uint64_t hash = FNV1A_64_OFFSET_BASIS) noexcept {
+    for (const auto b : bytes) {
+        hash ^= static_cast<std::uint64_t>(b);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/** @copydoc fnv1a_64 */
+[[nodiscard]] constexpr std::uint64_t fnv1a_64(std::string_view text,
+                                               std::uint64_t hash = FNV1A_64_OFFSET_BASIS) noexcept {
+    for (const auto c : text) {
+        hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(c));
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Finalizer that spreads every input bit over the whole result.
+ *
+ * Hashes combined with `+` or `^` should be mixed first, so that equal
+ * inputs in different positions do not cancel out.
+ */
+[[nodiscard]] constexpr std::uint64_t mix_64(std::uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_HASH_HPP
@@ -0,0 +1,216 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_INSTRUMENTATION_HPP
+#define XML_STREAM_PARSER_INSTRUMENTATION_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace xml_stream_parser {
+
+/**
+ * Load instrumentation is compiled out unless `XML_STREAM_PARSER_INSTRUMENTATION`
+ * is defined (CMake option of the same name). When it is out, `PhaseTimer`
+ * and `StatsScope` are empty types and every call on them is a no-op.
+ *
+ * Phase times are always measured when enabled. Allocation counts are only
+ * collected if the program also includes `allocation_hooks.hpp` in exactly
+ * one translation unit, which replaces the global `operator new`.
+ */
+#ifdef XML_STREAM_PARSER_INSTRUMENTATION
+inline constexpr bool INSTRUMENTATION_ENABLED = true;
+#else
+inline constexpr bool INSTRUMENTATION_ENABLED = false;
+#endif
+
+/**
+ * @brief The phases of loading a stream set that are measured separately.
+ */
+enum class LoadPhase : std::uint8_t {
+    index,                ///< Building the `StreamIndex`
+    fields,               ///< Reading a stream's attributes
+    enum_parsing,         ///< Direction, precision, I/O type, clobber mode, defaults
+    interval_resolution,  ///< Resolving and parsing intervals
+    members,              ///< Collecting a stream's var, file and nested stream children
+    path_handling,        ///< Filename template compilation and output directories
+    count
+};
+
+inline constexpr std::size_t LOAD_PHASE_COUNT = static_cast<std::size_t>(LoadPhase::count);
+
+/**
+ * @brief Cost of one load phase.
+ */
+struct PhaseStats {
+    std::uint64_t allocations{0};
+    std::uint64_t bytes{0};
+    std::chrono::nanoseconds elapsed{0};
+
+    PhaseStats& operator+=(const PhaseStats& other) noexcept {
+        allocations += other.allocations;
+        bytes       += other.bytes;
+        elapsed     += other.elapsed;
+        return *this;
+    }
+};
+
+/**
+ * @brief Per-load statistics, filled in when `LoadOptions::stats` is set.
+ *
+ * In a parallel load the per-worker statistics are summed, so `elapsed`
+ * is CPU time across workers rather than wall time.
+ */
+struct LoadStats {
+    std::array<PhaseStats, LOAD_PHASE_COUNT> phases{};
+
+    /// Streams loaded.
+    std::size_t streams{0};
+
+    [[nodiscard]] PhaseStats& operator[](LoadPhase phase) noexcept {
+        return phases[static_cast<std::size_t>(phase)];
+    }
+
+    [[nodiscard]] const PhaseStats& operator[](LoadPhase phase) const noexcept {
+        return phases[static_cast<std::size_t>(phase)];
+    }
+
+    /** @return The sum over all phases. */
+    [[nodiscard]] PhaseStats total() const noexcept {
+        PhaseStats sum;
+        for (const auto& phase : phases)
+            sum += phase;
+        return sum;
+    }
+
+    LoadStats& operator+=(const LoadStats& other) noexcept {
+        for (std::size_t i = 0; i < LOAD_PHASE_COUNT; ++i)
+            phases[i] += other.phases[i];
+        streams += other.streams;
+        return *this;
+    }
+};
+
+/** @return The name of a phase, for logging. */
+[[nodiscard]] constexpr const char* to_string(LoadPhase phase) noexcept {
+    switch (phase) {
+        case LoadPhase::index:               return "index";
+        case LoadPhase::fields:              return "fields";
+        case LoadPhase::enum_parsing:        return "enum_parsing";
+        case LoadPhase::interval_resolution: return "interval_resolution";
+        case LoadPhase::members:             return "members";
+        case LoadPhase::path_handling:       return "path_handling";
+        case LoadPhase::count:               break;
+    }
+    return "unknown";
+}
+
+#ifdef XML_STREAM_PARSER_INSTRUMENTATION
+
+namespace detail {
+
+/// Allocations made by this thread, maintained by `allocation_hooks.hpp`.
+struct AllocationCounters {
+    std::uint64_t allocations{0};
+    std::uint64_t bytes{0};
+};
+
+inline thread_local AllocationCounters thread_allocations;
+
+/// Statistics collected on this thread, or nullptr when no load is being measured.
+inline thread_local LoadStats* thread_stats = nullptr;
+
+} // namespace detail
+
+/**
+ * @class StatsScope
+ * @brief Directs the calling thread's measurements into `stats` for its lifetime.
+ *
+ * Scopes nest; the previous sink is restored on destruction. A null pointer
+ * disables collection within the scope.
+ */
+class StatsScope {
+public:
+    explicit StatsScope(LoadStats* stats) noexcept
+        : m_previous{std::exchange(detail::thread_stats, stats)} {}
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+    ~StatsScope() { detail::thread_stats = m_previous; }
+
+private:
+    LoadStats* m_previous;
+};
+
+/**
+ * @class PhaseTimer
+ * @brief Attributes time and allocations to a sequence of phases.
+ *
+ * Starts in one phase; `next()` closes it and opens another, so
+ * consecutive phases cost one clock read per transition. The last phase is
+ * closed on destruction. Does nothing outside a `StatsScope`.
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(LoadPhase phase) noexcept : m_stats{detail::thread_stats} {
+        if (m_stats)
+            start(phase);
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    ~PhaseTimer() {
+        if (m_stats)
+            stop();
+    }
+
+    /** @brief Ends the current phase and begins `phase`. */
+    void next(LoadPhase phase) noexcept {
+        if (m_stats) {
+            stop();
+            start(phase);
+        }
+    }
+
+private:
+    void start(LoadPhase phase) noexcept {
+        m_phase       = phase;
+        m_allocations = detail::thread_allocations;
+        m_start       = std::chrono::steady_clock::now();
+    }
+
+    void stop() noexcept {
+        const auto now = std::chrono::steady_clock::now();
+        auto& phase = (*m_stats)[m_phase];
+        phase.allocations += detail::thread_allocations.allocations - m_allocations.allocations;
+        phase.bytes       += detail::thread_allocations.bytes - m_allocations.bytes;
+        phase.elapsed     += now - m_start;
+    }
+
+    LoadStats* m_stats;
+    LoadPhase m_phase{};
+    detail::AllocationCounters m_allocations{};
+    std::chrono::steady_clock::time_point m_start{};
+};
+
+#else
+
+class StatsScope {
+public:
+    explicit constexpr StatsScope(LoadStats*) noexcept {}
+};
+
+class PhaseTimer {
+public:
+    explicit constexpr PhaseTimer(LoadPhase) noexcept {}
+    constexpr void next(LoadPhase) noexcept {}
+};
+
+#endif // XML_STREAM_PARSER_INSTRUMENTATION
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_INSTRUMENTATION_HPP
@@ -0,0 +1,192 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_INTERVAL_HPP
+#define XML_STREAM_PARSER_INTERVAL_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <optional>
+#include <string_view>
+
+#include "parse.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @class Interval
+ * @brief A stream interval parsed once from its MPAS string form.
+ *
+ * An interval is either one of the special tags (`none`, `initial_only`,
+ * `final_only`) or a duration made of a calendar part in months and a fixed
+ * part in seconds. Months are kept separate because their length depends on
+ * the model calendar.
+ *
+ * Accepted duration forms:
+ * - `[[Y-]M-]D_h:m:s`, e.g. `1_00:00:00`, `0001-00-00_00:00:00`
+ * - `h:m:s`, `m:s` or `s`, e.g. `6:00:00`, `100`
+ * - an integer with a unit suffix `s`, `m`, `h` or `d`, e.g. `3h`
+ *
+ * Every field is a non-negative decimal integer. An empty string is `none`.
+ */
+class Interval {
+public:
+    enum class Kind : std::uint8_t { none, initial_only, final_only, duration };
+
+    /** Constructs a `none` interval. */
+    constexpr Interval() = default;
+
+    /** @return A duration of `months` calendar months plus `seconds`. */
+    [[nodiscard]] static constexpr Interval duration(std::chrono::seconds seconds,
+                                                     std::int64_t months = 0) noexcept {
+        Interval interval{Kind::duration};
+        interval.m_seconds = seconds.count();
+        interval.m_months  = months;
+        return interval;
+    }
+
+    /**
+     * @brief Parses an interval string.
+     * @return The interval, or std::nullopt if `text` is malformed.
+     */
+    [[nodiscard]] static constexpr std::optional<Interval> try_parse(std::string_view text) noexcept {
+        if (text.empty() || text == "none")  return Interval{Kind::none};
+        if (text == "initial_only")          return Interval{Kind::initial_only};
+        if (text == "final_only")            return Interval{Kind::final_only};
+
+        if (const auto scale = unit_seconds(text.back())) {
+            const auto count = parse_field(text.substr(0, text.size() - 1));
+            if (!count)
+                return std::nullopt;
+            return duration(std::chrono::seconds{*count * scale});
+        }
+
+        std::int64_t months = 0;
+        std::int64_t seconds = 0;
+
+        auto time = text;
+        if (const auto underscore = text.find('_'); underscore != std::string_view::npos) {
+            // [[Y-]M-]D, read right to left.
+            constexpr std::int64_t date_scale[] = {86'400, 1, 12};
+            auto date = text.substr(0, underscore);
+            time      = text.substr(underscore + 1);
+            for (int field = 0;; ++field) {
+                if (field == 3)
+                    return std::nullopt;
+                const auto dash  = date.rfind('-');
+                const auto value = parse_field(dash == std::string_view::npos ? date : date.substr(dash + 1));
+                if (!value)
+                    return std::nullopt;
+                (field == 0 ? seconds : months) += *value * date_scale[field];
+                if (dash == std::string_view::npos)
+                    break;
+                date = date.substr(0, dash);
+            }
+        }
+
+        // [[h:]m:]s, read right to left.
+        constexpr std::int64_t time_scale[] = {1, 60, 3600};
+        for (int field = 0;; ++field) {
+            if (field == 3)
+                return std::nullopt;
+            const auto colon = time.rfind(':');
+            const auto value = parse_field(colon == std::string_view::npos ? time : time.substr(colon + 1));
+            if (!value)
+                return std::nullopt;
+            seconds += *value * time_scale[field];
+            if (colon == std::string_view::npos)
+                break;
+            time = time.substr(0, colon);
+        }
+
+        return duration(std::chrono::seconds{seconds}, months);
+    }
+
+    /**
+     * @brief Parses an interval string.
+     * @throws StreamIntervalError if `text` is malformed.
+     */
+    [[nodiscard]] static constexpr Interval parse(std::string_view text) {
+        if (const auto interval = try_parse(text))
+            return *interval;
+        throw StreamIntervalError(std::format("Malformed interval '{}'", text));
+    }
+
+    /** @return The interval's kind. */
+    [[nodiscard]] constexpr Kind kind() const noexcept { return m_kind; }
+
+    /** @return True for a duration, false for the special tags. */
+    [[nodiscard]] constexpr bool is_duration() const noexcept { return m_kind == Kind::duration; }
+
+    /** @return The fixed-length part of a duration; zero for special tags. */
+    [[nodiscard]] constexpr std::chrono::seconds seconds() const noexcept {
+        return std::chrono::seconds{m_seconds};
+    }
+
+    /** @return The calendar-month part of a duration (years count as 12); zero for special tags. */
+    [[nodiscard]] constexpr std::int64_t months() const noexcept { return m_months; }
+
+    [[nodiscard]] constexpr bool operator==(const Interval&) const noexcept = default;
+
+private:
+    /// Longest accepted field; keeps every product and sum well inside std::int64_t.
+    static constexpr std::size_t MAX_FIELD_DIGITS = 12;
+
+    constexpr explicit Interval(Kind kind) noexcept : m_kind{kind} {}
+
+    static constexpr std::int64_t unit_seconds(char unit) noexcept {
+        switch (unit) {
+            case 's': return 1;
+            case 'm': return 60;
+            case 'h': return 3600;
+            case 'd': return 86'400;
+            default:  return 0;
+        }
+    }
+
+    static constexpr std::optional<std::int64_t> parse_field(std::string_view digits) noexcept {
+        if (digits.empty() || digits.size() > MAX_FIELD_DIGITS)
+            return std::nullopt;
+        std::int64_t value = 0;
+        for (const char c : digits) {
+            if (c < '0' || c > '9')
+                return std::nullopt;
+            value = value * 10 + (c - '0');
+        }
+        return value;
+    }
+
+    Kind m_kind{Kind::none};
+    std::int64_t m_seconds{0};
+    std::int64_t m_months{0};
+};
+
+/**
+ * @brief Non-throwing `parse_stream_interval`.
+ */
+constexpr std::expected<Interval, StreamError> try_parse_stream_interval(std::string_view value,
+                                                                         std::string_view attribute,
+                                                                         std::string_view stream_id) {
+    if (const auto interval = Interval::try_parse(value))
+        return *interval;
+    return std::unexpected(StreamError{StreamErrorCode::malformed_interval, std::format(
+        "Malformed {} '{}' in stream '{}'", attribute, value, stream_id), attribute});
+}
+
+/**
+ * @brief Parses the interval held by a stream attribute.
+ * @throws StreamIntervalError naming the stream and attribute if `value` is malformed.
+ */
+constexpr Interval parse_stream_interval(std::string_view value,
+                                         std::string_view attribute,
+                                         std::string_view stream_id) {
+    auto interval = try_parse_stream_interval(value, attribute, stream_id);
+    if (!interval)
+        throw StreamIntervalError(interval.error());
+    return *interval;
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_INTERVAL_HPP
@@ -0,0 +1,257 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_INTERVAL_RESOLVER_HPP
+#define XML_STREAM_PARSER_INTERVAL_RESOLVER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "parse.hpp"
+#include "stream_index.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @brief Options controlling how `IntervalResolver` follows `stream:` references.
+ */
+struct IntervalResolverOptions {
+    /// Resolve exactly one hop and require the target value to be final,
+    /// matching `extract_stream_interval`.
+    bool strict{false};
+
+    /// Maximum number of hops followed in chained mode, counting the first;
+    /// 0 rejects every reference. Strict mode always follows exactly one.
+    std::size_t max_depth{16};
+
+    [[nodiscard]] bool operator==(const IntervalResolverOptions&) const = default;
+};
+
+/**
+ * @class IntervalResolver
+ * @brief Memoizing resolver for `stream:NAME:attr` interval references.
+ *
+ * In chained mode a reference whose target is itself a reference is
+ * followed hop by hop, up to `max_depth` hops. The `(stream, attribute)`
+ * pairs on the current chain form a visited set, so a cycle of any length
+ * is reported instead of recursing forever.
+ *
+ * Every resolved `(stream, attribute)` pair is memoized, so each edge in the
+ * reference graph is followed once per document no matter how many streams
+ * point at it. The memo is guarded by a mutex so one resolver can be shared
+ * by a parallel `StreamSet` load; concurrent misses on the same edge may
+ * both resolve it, with identical results.
+ *
+ * The resolver can be passed wherever a `StreamLookup` is accepted, such as
+ * `Stream::load_from_xml`.
+ *
+ * @tparam Node XML node adapter type satisfying the `XmlNodeLike` concept.
+ */
+template<XmlNodeLike Node>
+class IntervalResolver {
+public:
+    /**
+     * @param index   Index of the streams document; must outlive the resolver.
+     * @param options Strict or chained resolution.
+     */
+    explicit IntervalResolver(const StreamIndex<Node>& index,
+                              IntervalResolverOptions options = {}) noexcept
+        : m_index{&index}, m_options{options} {}
+
+    /**
+     * @brief Resolves an interval attribute value.
+     *
+     * @param interval      The raw attribute value.
+     * @param interval_type The attribute holding it ("input_interval" or "output_interval").
+     * @param stream_id     The stream the attribute belongs to.
+     * @return The final interval value.
+     * @throws StreamIntervalError on invalid, missing, recursive or cyclic references.
+     */
+    [[nodiscard]] std::string resolve(std::string_view interval,
+                                      std::string_view interval_type,
+                                      std::string_view stream_id) const {
+        auto resolved = try_resolve(interval, interval_type, stream_id);
+        if (!resolved)
+            throw StreamIntervalError(resolved.error());
+        return *std::move(resolved);
+    }
+
+    /**
+     * @brief Non-throwing `resolve`.
+     * @return The final interval value, or the first error met along the chain.
+     */
+    [[nodiscard]] std::expected<std::string, StreamError> try_resolve(std::string_view interval,
+                                                                      std::string_view interval_type,
+                                                                      std::string_view stream_id) const {
+        if (!interval.starts_with("stream:"))
+            return std::string(interval);
+
+        std::vector<std::pair<std::string_view, std::string_view>> chain{{stream_id, interval_type}};
+        auto resolved = follow(interval, chain);
+        if (!resolved)
+            return std::unexpected(std::move(resolved.error()));
+        return std::move(resolved->value);
+    }
+
+    /** @return The index the resolver looks streams up in. */
+    [[nodiscard]] const StreamIndex<Node>& index() const noexcept { return *m_index; }
+
+    /** @return The number of memoized `(stream, attribute)` pairs. */
+    [[nodiscard]] std::size_t memo_size() const {
+        const std::scoped_lock lock{m_mutex};
+        return m_memo[0].size() + m_memo[1].size();
+    }
+
+private:
+    /// A final interval value and the number of hops still needed to reach it.
+    struct Resolved {
+        std::string value;
+        std::size_t hops{0};
+    };
+
+    using Memo = std::unordered_map<std::string, Resolved, StringHash, std::equal_to<>>;
+
+    /// Memo slot for a validated interval attribute.
+    static std::size_t slot(std::string_view attr) noexcept {
+        return attr == "input_interval" ? 0 : 1;
+    }
+
+    /**
+     * Resolves `reference`, which is held by the last pair on `chain`.
+     *
+     * The chain already spans `chain.size()` hops once the target is reached.
+     * Memoized entries carry the hops remaining past their target, so the
+     * depth limit is enforced identically whether or not an edge was cached
+     * by an earlier (or concurrent) resolution.
+     */
+    std::expected<Resolved, StreamError> follow(std::string_view reference,
+                                                std::vector<std::pair<std::string_view, std::string_view>>& chain) const {
+        auto target = reference.substr(7); // remove "stream:"
+
+        const auto pos = target.find(':');
+        if (pos == std::string_view::npos)
+            return std::unexpected(detail::malformed_reference_error());
+
+        const auto target_stream = target.substr(0, pos);
+        const auto target_attr   = target.substr(pos + 1);
+        const auto& [stream_id, interval_type] = chain.back();
+
+        if (auto checked = check_not_recursive(stream_id, interval_type, target_stream, target_attr); !checked)
+            return std::unexpected(std::move(checked.error()));
+        if (auto checked = check_valid_attribute(target_attr); !checked)
+            return std::unexpected(std::move(checked.error()));
+
+        if (auto cached = lookup(target_stream, target_attr)) {
+            if (auto checked = check_within_depth(chain.size() + cached->hops); !checked)
+                return std::unexpected(std::move(checked.error()));
+            return std::move(*cached);
+        }
+
+        if (std::ranges::find(chain, std::pair{target_stream, target_attr}) != chain.end())
+            return std::unexpected(StreamError{StreamErrorCode::cyclic_reference, std::format(
+                "Cyclic interval reference through '{}:{}'", target_stream, target_attr)});
+
+        const auto node = try_resolve_target_stream(*m_index, target_stream);
+        if (!node)
+            return std::unexpected(node.error());
+        if (!node->has_attribute(target_attr))
+            return std::unexpected(detail::missing_attribute_error(target_attr, target_stream));
+
+        const auto raw = node->get_attribute(target_attr);
+        const std::string_view value{raw};
+
+        Resolved resolved;
+        if (m_options.strict || !value.starts_with("stream:")) {
+            if (auto checked = check_resolved_value_is_final(value); !checked)
+                return std::unexpected(std::move(checked.error()));
+            if (auto checked = check_within_depth(chain.size()); !checked)
+                return std::unexpected(std::move(checked.error()));
+            resolved.value = std::string(value);
+        } else {
+            if (auto checked = check_within_depth(chain.size() + 1); !checked)
+                return std::unexpected(std::move(checked.error()));
+            chain.emplace_back(target_stream, target_attr);
+            auto next = follow(value, chain);
+            chain.pop_back();
+            if (!next)
+                return next;
+            resolved = std::move(*next);
+            ++resolved.hops;
+        }
+
+        store(target_stream, target_attr, resolved);
+        return resolved;
+    }
+
+    std::expected<void, StreamError> check_within_depth(std::size_t hops) const {
+        if (!m_options.strict && hops > m_options.max_depth)
+            return std::unexpected(StreamError{StreamErrorCode::reference_too_deep, std::format(
+                "Interval reference chain exceeds {} hops", m_options.max_depth)});
+        return {};
+    }
+
+    std::optional<Resolved> lookup(std::string_view stream, std::string_view attr) const {
+        const std::scoped_lock lock{m_mutex};
+        const auto& memo = m_memo[slot(attr)];
+        if (const auto it = memo.find(stream); it != memo.end())
+            return it->second;
+        return std::nullopt;
+    }
+
+    void store(std::string_view stream, std::string_view attr, const Resolved& value) const {
+        const std::scoped_lock lock{m_mutex};
+        m_memo[slot(attr)].try_emplace(std::string(stream), value);
+    }
+
+    const StreamIndex<Node>* m_index;
+    IntervalResolverOptions m_options;
+
+    mutable std::mutex m_mutex;
+    mutable std::array<Memo, 2> m_memo;
+};
+
+/**
+ * @brief Resolves a referenced stream through the resolver's index.
+ *
+ * Makes `IntervalResolver` a `StreamLookup`.
+ */
+template<XmlNodeLike Node>
+Node resolve_target_stream(const IntervalResolver<Node>& resolver, std::string_view name) {
+    return resolve_target_stream(resolver.index(), name);
+}
+
+/**
+ * @brief Resolves an interval reference through a memoizing resolver.
+ *
+ * Selected over the generic overload whenever `parse_interval` /
+ * `parse_filename_interval` are given an `IntervalResolver`.
+ */
+template<XmlNodeLike Node>
+std::string extract_stream_interval(std::string_view interval,
+                                    std::string_view interval_type,
+                                    std::string_view stream_id,
+                                    const IntervalResolver<Node>& resolver) {
+    return resolver.resolve(interval, interval_type, stream_id);
+}
+
+/** @brief Non-throwing counterpart, selected for `try_parse_interval_into`. */
+template<XmlNodeLike Node>
+std::expected<std::string, StreamError> try_extract_stream_interval(std::string_view interval,
+                                                                    std::string_view interval_type,
+                                                                    std::string_view stream_id,
+                                                                    const IntervalResolver<Node>& resolver) {
+    return resolver.try_resolve(interval, interval_type, stream_id);
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_INTERVAL_RESOLVER_HPP
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_KEYWORD_TABLE_HPP
+#define XML_STREAM_PARSER_KEYWORD_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace xml_stream_parser {
+
+/**
+ * @class KeywordTable
+ * @brief Compile-time perfect hash over a fixed set of keywords.
+ *
+ * The slot table is generated in the constructor from the keyword list and
+ * a caller-supplied hash. If two keywords land in the same slot the
+ * constructor throws, which turns into a compile error when the table is
+ * declared `constexpr`. A lookup is therefore one hash, one slot load and
+ * one string comparison.
+ *
+ * @tparam N         Number of keywords.
+ * @tparam TableSize Number of slots; must be at least `N`.
+ * @tparam Hash      Stateless callable `std::size_t(std::string_view)`.
+ */
+template<std::size_t N, std::size_t TableSize, typename Hash>
+class KeywordTable {
+    static_assert(TableSize >= N, "KeywordTable needs at least one slot per keyword");
+    static_assert(N < 0xFF, "KeywordTable supports at most 254 keywords");
+
+public:
+    constexpr KeywordTable(const std::array<std::string_view, N>& keywords, Hash hash)
+        : m_keywords{keywords}, m_hash{hash} {
+        m_slots.fill(empty_slot);
+        for (std::size_t i = 0; i < N; ++i) {
+            auto& slot = m_slots[m_hash(keywords[i]) % TableSize];
+            if (slot != empty_slot)
+                throw std::logic_error("KeywordTable hash is not perfect for this keyword set");
+            slot = static_cast<std::uint8_t>(i);
+        }
+    }
+
+    /**
+     * @brief Classifies a keyword.
+     * @return The keyword's position in the constructor list, or std::nullopt if unknown.
+     */
+    [[nodiscard]] constexpr std::optional<std::size_t> find(std::string_view key) const noexcept {
+        const auto slot = m_slots[m_hash(key) % TableSize];
+        if (slot == empty_slot || m_keywords[slot] != key)
+            return std::nullopt;
+        return slot;
+    }
+
+    /** @return The keyword at the given position. */
+    [[nodiscard]] constexpr std::string_view operator[](std::size_t i) const noexcept {
+        return m_keywords[i];
+    }
+
+    /** @return The number of keywords. */
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return N; }
+
+private:
+    static constexpr std::uint8_t empty_slot = 0xFF;
+
+    std::array<std::string_view, N> m_keywords;
+    std::array<std::uint8_t, TableSize> m_slots{};
+    Hash m_hash;
+};
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_KEYWORD_TABLE_HPP
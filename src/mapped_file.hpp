@@ -0,0 +1,129 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_MAPPED_FILE_HPP
+#define XML_STREAM_PARSER_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace xml_stream_parser {
+
+/**
+ * @class MappedFile
+ * @brief RAII owner of a whole-file POSIX memory mapping.
+ *
+ * Two modes are supported:
+ *  - `read_only`: shared, read-only mapping.
+ *  - `copy_on_write`: private, writable mapping. Writes are visible only to
+ *    this process and never reach the file; the kernel copies each page the
+ *    first time it is written.
+ *
+ * An empty file yields an empty mapping (`data() == nullptr`, `size() == 0`).
+ */
+class MappedFile {
+public:
+    enum class Mode { read_only, copy_on_write };
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : m_data{std::exchange(other.m_data, nullptr)},
+          m_size{std::exchange(other.m_size, 0)} {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { release(); }
+
+    /**
+     * @brief Maps the whole file at `path`.
+     * @throws std::runtime_error if the file cannot be opened, inspected or mapped.
+     */
+    static MappedFile open(const std::string& path, Mode mode) {
+        std::error_code ec;
+        auto file = open(path, mode, ec);
+        if (ec)
+            throw std::runtime_error(std::format(
+                "Failed to map '{}': {}", path, ec.message()));
+        return file;
+    }
+
+    /**
+     * @brief Maps the whole file at `path`, reporting failure through `ec`.
+     */
+    static MappedFile open(const std::string& path, Mode mode, std::error_code& ec) noexcept {
+        ec.clear();
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            ec.assign(errno, std::generic_category());
+            return {};
+        }
+
+        MappedFile file;
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ec.assign(errno, std::generic_category());
+        } else if (st.st_size > 0) {
+            const auto size = static_cast<std::size_t>(st.st_size);
+            const int prot  = mode == Mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            const int flags = mode == Mode::read_only ? MAP_SHARED : MAP_PRIVATE;
+            void* data = ::mmap(nullptr, size, prot, flags, fd, 0);
+            if (data == MAP_FAILED) {
+                ec.assign(errno, std::generic_category());
+            } else {
+                ::madvise(data, size, MADV_SEQUENTIAL);
+                file.m_data = data;
+                file.m_size = size;
+            }
+        }
+        ::close(fd);
+        return file;
+    }
+
+    /** @return The start of the mapping, or nullptr if empty. */
+    [[nodiscard]] void* data() const noexcept { return m_data; }
+
+    /** @return The size of the mapping in bytes. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    /** @return True if nothing is mapped. */
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    /** @return The mapped bytes. */
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept {
+        return {static_cast<const std::byte*>(m_data), m_size};
+    }
+
+private:
+    void release() noexcept {
+        if (m_data)
+            ::munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    void* m_data{nullptr};
+    std::size_t m_size{0};
+};
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_MAPPED_FILE_HPP
@@ -0,0 +1,159 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_MEMBER_FILES_HPP
+#define XML_STREAM_PARSER_MEMBER_FILES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "filesystem.hpp"
+#include "stream_index.hpp"
+#include "stream_members.hpp"
+#include "stream_set.hpp"
+#include "worker_pool.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @class MemberFiles
+ * @brief The `<file>` variable-list includes of a stream set, read and split.
+ *
+ * Each file's text is held once and its member names are views into it, so
+ * a file shared by many streams costs one read and one split. Built by
+ * `load_member_files`; pass it to `BasicStreamMembers::expand_files` to
+ * expand any stream of the set.
+ *
+ * Movable but not copyable, since the names view the stored text.
+ */
+class MemberFiles {
+public:
+    MemberFiles() = default;
+    MemberFiles(const MemberFiles&) = delete;
+    MemberFiles& operator=(const MemberFiles&) = delete;
+    MemberFiles(MemberFiles&&) noexcept = default;
+    MemberFiles& operator=(MemberFiles&&) noexcept = default;
+
+    /** @return The number of distinct files read. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_files.size(); }
+
+    /** @return True if `file`, as named by a `<file>` element, was read. */
+    [[nodiscard]] bool contains(std::string_view file) const noexcept {
+        return m_by_name.contains(file);
+    }
+
+    /**
+     * @brief The member names listed by a file, in file order.
+     * @param file The file as named by a `<file>` element.
+     * @throws std::runtime_error if the file was not among those loaded.
+     */
+    [[nodiscard]] const std::vector<std::string_view>& operator()(std::string_view file) const {
+        const auto it = m_by_name.find(file);
+        if (it == m_by_name.end())
+            throw std::runtime_error(std::format("Member file '{}' was not loaded", file));
+        return m_files[it->second].names;
+    }
+
+private:
+    struct File {
+        std::string name;
+        std::string text;
+        std::vector<std::string_view> names;
+    };
+
+    friend MemberFiles load_member_files(const IXmlFileSystem&, std::span<const std::string>,
+                                         const fs::path&, unsigned);
+
+    /// Never resized once filled, so the views in `names` stay valid across moves.
+    std::vector<File> m_files;
+    std::unordered_map<std::string, std::size_t, StringHash, std::equal_to<>> m_by_name;
+};
+
+/**
+ * @brief The distinct `<file>` includes named by a loaded stream set.
+ *
+ * The names are recorded while the XML is loaded, so no further pass over
+ * the document is needed.
+ *
+ * @return File names in order of first appearance.
+ */
+template<XmlNodeLike Node, typename Allocator>
+std::vector<std::string> member_file_names(const BasicStreamSet<Node, Allocator>& streams) {
+    std::vector<std::string> names;
+    std::unordered_set<std::string_view> seen;
+    for (const auto& stream : streams)
+        for (const auto member : stream.get_members())
+            if (member.kind == MemberKind::file && seen.insert(member.name).second)
+                names.emplace_back(member.name);
+    return names;
+}
+
+/**
+ * @brief Reads and splits `<file>` includes concurrently.
+ *
+ * Each distinct name is read once, through `fs.read_file`, on up to
+ * `max_parallel` threads; the same threads split the text into member
+ * names. Nothing is read until this is called, so a set whose variable
+ * lists are never needed never touches the files.
+ *
+ * @param fs           Must tolerate concurrent `read_file` calls.
+ * @param files        File names as written in `<file>` elements.
+ * @param directory    Directory relative file names are resolved against.
+ * @param max_parallel Upper bound on concurrent reads; 0 is treated as 1.
+ * @throws std::runtime_error naming the first file, in `files` order, that
+ *         could not be read.
+ */
+inline MemberFiles load_member_files(const IXmlFileSystem& fs,
+                                     std::span<const std::string> files,
+                                     const fs::path& directory = {},
+                                     unsigned max_parallel = 8) {
+    MemberFiles result;
+    for (const auto& file : files) {
+        if (result.m_by_name.try_emplace(file, result.m_files.size()).second)
+            result.m_files.push_back({file, {}, {}});
+    }
+
+    auto& entries = result.m_files;
+    std::vector<char> missing(entries.size(), 0);
+
+    const auto workers = std::clamp<std::size_t>(entries.size(), 1, std::max(1u, max_parallel));
+    detail::for_each_index(entries.size(), workers, [&](std::size_t i) {
+        auto text = fs.read_file((directory / entries[i].name).string());
+        if (!text) {
+            missing[i] = 1;
+            return;
+        }
+        entries[i].text  = std::move(*text);
+        entries[i].names = detail::split_member_lines(entries[i].text);
+    });
+
+    for (std::size_t i = 0; i < entries.size(); ++i)
+        if (missing[i])
+            throw std::runtime_error(std::format(
+                "Failed to read member file '{}'", (directory / entries[i].name).string()));
+    return result;
+}
+
+/**
+ * @brief Reads every `<file>` include named by a loaded stream set.
+ * @copydetails load_member_files(const IXmlFileSystem&, std::span<const std::string>, const fs::path&, unsigned)
+ */
+template<XmlNodeLike Node, typename Allocator>
+MemberFiles load_member_files(const IXmlFileSystem& fs,
+                              const BasicStreamSet<Node, Allocator>& streams,
+                              const fs::path& directory = {},
+                              unsigned max_parallel = 8) {
+    return load_member_files(fs, member_file_names(streams), directory, max_parallel);
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_MEMBER_FILES_HPP
@@ -0,0 +1,329 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_OUTPUT_PATHS_HPP
+#define XML_STREAM_PARSER_OUTPUT_PATHS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <future>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "filesystem.hpp"
+#include "instrumentation.hpp"
+#include "parse.hpp"
+#include "stream_index.hpp"
+#include "stream_set.hpp"
+#include "worker_pool.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @brief One stream whose output directory should be prepared.
+ *
+ * Views the caller's strings; they need only outlive the construction of an
+ * `OutputDirectoryPlan`.
+ */
+struct OutputPath {
+    std::string_view stream_id;
+
+    /// Stream direction type; only output streams (2 and 3) are prepared.
+    int type{0};
+
+    std::string_view filename_template;
+};
+
+/**
+ * @brief A stream whose output directory could not be prepared.
+ */
+struct OutputPathError {
+    std::string stream_id;
+    std::string directory;
+
+    /// Same text `build_stream_path` would have thrown.
+    std::string message;
+};
+
+/**
+ * @brief The distinct output directories of a batch of streams.
+ *
+ * Directories are lexically normalized, so `out/`, `out` and `./out` are
+ * one entry, and ordered deepest first: once a directory exists, all of its
+ * ancestors in the plan are known to exist without asking the filesystem.
+ */
+class OutputDirectoryPlan {
+public:
+    /** @brief A distinct directory and the streams writing into it. */
+    struct Directory {
+        std::string path;
+        std::vector<std::string> streams;
+    };
+
+    OutputDirectoryPlan() = default;
+
+    /** @param paths Streams to plan for; non-output streams and bare filenames are skipped. */
+    explicit OutputDirectoryPlan(std::span<const OutputPath> paths) {
+        std::unordered_map<std::string, std::size_t, StringHash, std::equal_to<>> by_path;
+        for (const auto& path : paths) {
+            if (path.type != 2 && path.type != 3)
+                continue;
+            auto dir = normalize(fs::path(path.filename_template).parent_path());
+            if (dir.empty())
+                continue;
+            const auto [it, inserted] = by_path.try_emplace(std::move(dir), m_directories.size());
+            if (inserted)
+                m_directories.push_back({it->first, {}});
+            m_directories[it->second].streams.emplace_back(path.stream_id);
+        }
+
+        std::ranges::stable_sort(m_directories, std::ranges::greater{},
+                                 [](const Directory& d) { return depth(d.path); });
+        group_related();
+    }
+
+    /** @return The distinct directories, deepest first. */
+    [[nodiscard]] const std::vector<Directory>& directories() const noexcept { return m_directories; }
+
+    /** @return The number of distinct directories. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_directories.size(); }
+
+    /** @return True if no stream needs a directory. */
+    [[nodiscard]] bool empty() const noexcept { return m_directories.empty(); }
+
+    /**
+     * @brief Directories partitioned so that no directory is an ancestor of
+     *        one in another group.
+     *
+     * Each group holds indices into `directories()`, deepest first. Groups
+     * can be prepared independently without losing ancestor collapsing.
+     */
+    [[nodiscard]] const std::vector<std::vector<std::size_t>>& groups() const noexcept { return m_groups; }
+
+    /// Lexically normal form of `dir`, without a trailing separator.
+    static std::string normalize(const fs::path& dir) {
+        auto normal = dir.lexically_normal();
+        if (!normal.has_filename() && normal.has_relative_path())
+            normal = normal.parent_path();
+        return normal == "." ? std::string{} : normal.string();
+    }
+
+private:
+    static std::size_t depth(std::string_view path) noexcept {
+        return static_cast<std::size_t>(std::ranges::count(path, '/'));
+    }
+
+    /// Unions every directory with its nearest planned ancestor.
+    void group_related() {
+        std::unordered_map<std::string_view, std::size_t> by_path;
+        for (std::size_t i = 0; i < m_directories.size(); ++i)
+            by_path.emplace(m_directories[i].path, i);
+
+        std::vector<std::size_t> parent(m_directories.size());
+        std::iota(parent.begin(), parent.end(), std::size_t{0});
+        auto root = [&](std::size_t i) {
+            while (parent[i] != i)
+                i = parent[i] = parent[parent[i]];
+            return i;
+        };
+
+        for (std::size_t i = 0; i < m_directories.size(); ++i) {
+            fs::path p{m_directories[i].path};
+            for (auto up = p.parent_path(); !up.empty() && up != p; p = up, up = p.parent_path()) {
+                if (const auto it = by_path.find(up.string()); it != by_path.end()) {
+                    parent[root(i)] = root(it->second);
+                    break;
+                }
+            }
+        }
+
+        std::unordered_map<std::size_t, std::size_t> group_of;
+        for (std::size_t i = 0; i < m_directories.size(); ++i) {
+            const auto [it, inserted] = group_of.try_emplace(root(i), m_groups.size());
+            if (inserted)
+                m_groups.emplace_back();
+            m_groups[it->second].push_back(i);
+        }
+    }
+
+    std::vector<Directory> m_directories;
+    std::vector<std::vector<std::size_t>> m_groups;
+};
+
+namespace detail {
+
+/**
+ * Prepares the planned directories at `indices`, deepest first, storing the
+ * errors for directory `i` in `errors[i]`.
+ */
+inline void prepare_directories(IXmlFileSystem& fs,
+                                const OutputDirectoryPlan& plan,
+                                std::span<const std::size_t> indices,
+                                std::vector<std::vector<OutputPathError>>& errors) {
+    std::unordered_set<std::string, StringHash, std::equal_to<>> present;
+
+    for (const auto i : indices) {
+        const auto& dir = plan.directories()[i];
+        auto fail = [&](std::string message) {
+            for (const auto& stream : dir.streams)
+                errors[i].push_back({stream, dir.path, message});
+        };
+
+        DirectoryStatus status;
+        if (present.contains(dir.path)) {
+            status = fs.can_write(dir.path) ? DirectoryStatus::writable : DirectoryStatus::not_writable;
+        } else {
+            status = fs.ensure_writable_directory(dir.path);
+            if (status == DirectoryStatus::create_failed) {
+                fail(std::format("Failed to create directory '{}'", dir.path));
+                continue;
+            }
+            for (fs::path p{dir.path}; !p.empty() && present.insert(p.string()).second; ) {
+                const auto parent = p.parent_path();
+                if (parent == p)
+                    break;
+                p = parent;
+            }
+        }
+
+        if (status == DirectoryStatus::not_writable)
+            fail(std::format("Directory '{}' is not writable", dir.path));
+    }
+}
+
+/// Concatenates per-directory errors in plan order.
+inline std::vector<OutputPathError> flatten(std::vector<std::vector<OutputPathError>> errors) {
+    std::vector<OutputPathError> all;
+    for (auto& dir_errors : errors)
+        std::ranges::move(dir_errors, std::back_inserter(all));
+    return all;
+}
+
+} // namespace detail
+
+/**
+ * @brief Ensures every output directory of a batch of streams exists and is writable.
+ *
+ * The batch equivalent of calling `handle_stream_output_path` per stream.
+ * Each distinct directory goes through `ensure_writable_directory` at most
+ * once, however many streams share it. Directories that are ancestors of
+ * one already found or created only get a `can_write` check.
+ *
+ * Failures do not stop the batch: every stream writing into a directory
+ * that could not be prepared gets its own error.
+ *
+ * @return One error per affected stream, in plan order; empty on success.
+ */
+inline std::vector<OutputPathError> prepare_output_paths(IXmlFileSystem& fs,
+                                                         const OutputDirectoryPlan& plan) {
+    const PhaseTimer timer{LoadPhase::path_handling};
+
+    std::vector<std::size_t> indices(plan.size());
+    std::iota(indices.begin(), indices.end(), std::size_t{0});
+
+    std::vector<std::vector<OutputPathError>> errors(plan.size());
+    detail::prepare_directories(fs, plan, indices, errors);
+    return detail::flatten(std::move(errors));
+}
+
+/** @copydoc prepare_output_paths(IXmlFileSystem&, const OutputDirectoryPlan&) */
+inline std::vector<OutputPathError> prepare_output_paths(IXmlFileSystem& fs,
+                                                         std::span<const OutputPath> paths) {
+    return prepare_output_paths(fs, OutputDirectoryPlan{paths});
+}
+
+/**
+ * @brief Prepares the output directories of every stream in a loaded set.
+ * @copydetails prepare_output_paths(IXmlFileSystem&, const OutputDirectoryPlan&)
+ */
+template<XmlNodeLike Node, typename Allocator>
+std::vector<OutputPathError> prepare_output_paths(IXmlFileSystem& fs,
+                                                  const BasicStreamSet<Node, Allocator>& streams) {
+    std::vector<OutputPath> paths;
+    paths.reserve(streams.size());
+    for (const auto& stream : streams)
+        paths.push_back({stream.get_stream_id(), stream.get_type(), stream.get_filename_template()});
+    return prepare_output_paths(fs, OutputDirectoryPlan{paths});
+}
+
+/**
+ * @brief Plans the output directories of every stream under a `<streams>` root.
+ *
+ * Reads only the `name`, `type` and `filename_template` attributes, so the
+ * plan is available before any stream is loaded; see
+ * `prepare_output_paths_async`.
+ */
+template<XmlNodeLike Node>
+OutputDirectoryPlan plan_output_directories(const StreamIndex<Node>& index) {
+    std::vector<std::string> storage;
+    storage.reserve(index.size() * 2);
+    std::vector<OutputPath> paths;
+    paths.reserve(index.size());
+    for (const auto& node : index.nodes()) {
+        const int type = parse_direction(std::string_view{node.get_attribute("type")});
+        if (type != 2 && type != 3)
+            continue;
+        storage.emplace_back(node.get_attribute("name"));
+        storage.emplace_back(node.get_attribute("filename_template"));
+        paths.push_back({{}, type, {}});
+    }
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        paths[i].stream_id         = storage[2 * i];
+        paths[i].filename_template = storage[2 * i + 1];
+    }
+    return OutputDirectoryPlan{paths};
+}
+
+/** @copydoc plan_output_directories(const StreamIndex<Node>&) */
+template<XmlNodeLike Node>
+OutputDirectoryPlan plan_output_directories(const Node& streams_root) {
+    return plan_output_directories(StreamIndex<Node>{streams_root});
+}
+
+/**
+ * @brief Prepares output directories in the background with bounded parallelism.
+ *
+ * Up to `max_parallel` threads issue the same calls as
+ * `prepare_output_paths` concurrently. Directories that are ancestors of
+ * one another are prepared by the same thread, deepest first, so ancestor
+ * collapsing still applies; unrelated directories proceed independently.
+ * The errors are identical to, and in the same order as, a serial run.
+ *
+ * Planning reads only three attributes, so the slow metadata calls can
+ * overlap with stream loading:
+ *
+ * @code
+ * auto pending = prepare_output_paths_async(fs, plan_output_directories(root));
+ * streams.load_from_xml(root);
+ * for (const auto& error : pending.get()) ...
+ * @endcode
+ *
+ * @param fs           Must tolerate concurrent calls (`XmlFileSystem` does) and
+ *                     outlive the returned future.
+ * @param plan         Directories to prepare.
+ * @param max_parallel Upper bound on concurrent threads; 0 is treated as 1.
+ * @return A future for one error per affected stream.
+ */
+inline std::future<std::vector<OutputPathError>>
+prepare_output_paths_async(IXmlFileSystem& fs, OutputDirectoryPlan plan, unsigned max_parallel = 8) {
+    return std::async(std::launch::async, [&fs, plan = std::move(plan), max_parallel] {
+        const auto& groups = plan.groups();
+        std::vector<std::vector<OutputPathError>> errors(plan.size());
+
+        const auto workers = std::clamp<std::size_t>(groups.size(), 1, std::max(1u, max_parallel));
+        detail::for_each_index(groups.size(), workers, [&](std::size_t g) {
+            detail::prepare_directories(fs, plan, groups[g], errors);
+        });
+        return detail::flatten(std::move(errors));
+    });
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_OUTPUT_PATHS_HPP
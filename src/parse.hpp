@@ -3,9 +3,11 @@
 #define XML_STREAM_PARSER_PARSE_HPP
 
 #include <array>
+#include <expected>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <memory_resource>
 #include <optional>
 #include <filesystem>
 #include <stdexcept>
@@ -13,7 +15,10 @@
 #include <format>
 
 #include "filesystem.hpp"
+#include "instrumentation.hpp"
 #include "parser_concepts.hpp"
+#include "stream_error.hpp"
+#include "stream_index.hpp"
 
 namespace xml_stream_parser {
 
@@ -25,6 +30,10 @@ class StreamIntervalError final : public std::runtime_error {
 public:
     explicit StreamIntervalError(std::string_view msg)
         : std::runtime_error(std::string(msg)) {}
+
+    /** @brief Throws the error a `try_` function returned. */
+    explicit StreamIntervalError(const StreamError& error)
+        : StreamIntervalError(error.message) {}
 };
 
 // ============================================================================
@@ -36,14 +45,41 @@ constexpr std::array VALID_ATTRS{
     "input_interval", "output_interval"
 };
 
+/** @brief Non-throwing `ensure_valid_attribute`. */
+constexpr std::expected<void, StreamError> check_valid_attribute(std::string_view attr) {
+    if (std::ranges::find(VALID_ATTRS, attr) == VALID_ATTRS.end())
+        return std::unexpected(StreamError{StreamErrorCode::invalid_reference_attribute,
+                                           std::format("Invalid referenced attribute '{}'", attr)});
+    return {};
+}
+
+/** @brief Non-throwing `ensure_not_recursive`. */
+constexpr std::expected<void, StreamError> check_not_recursive(std::string_view stream_id,
+                                                               std::string_view interval_type,
+                                                               std::string_view target_stream,
+                                                               std::string_view target_attr) {
+    if (target_stream == stream_id && target_attr == interval_type)
+        return std::unexpected(StreamError{StreamErrorCode::self_reference, "Self-referencing interval detected"});
+    return {};
+}
+
+/** @brief Non-throwing `ensure_resolved_value_is_final`. */
+constexpr std::expected<void, StreamError> check_resolved_value_is_final(std::string_view resolved) {
+    if (resolved == "input_interval" ||
+        resolved == "output_interval" ||
+        resolved.starts_with("stream:"))
+        return std::unexpected(StreamError{StreamErrorCode::unexpandable_reference,
+                                           "Recursive or unexpandable interval reference"});
+    return {};
+}
+
 /**
  * @brief Ensures that an attribute name is valid for a stream interval.
  * @throws StreamIntervalError if the attribute is not recognized.
  */
 constexpr void ensure_valid_attribute(std::string_view attr) {
-    if (std::ranges::find(VALID_ATTRS, attr) == VALID_ATTRS.end())
-        throw StreamIntervalError(std::format(
-            "Invalid referenced attribute '{}'", attr));
+    if (auto checked = check_valid_attribute(attr); !checked)
+        throw StreamIntervalError(checked.error());
 }
 
 /**
@@ -54,8 +90,8 @@ constexpr void ensure_not_recursive(std::string_view stream_id,
                                     std::string_view interval_type,
                                     std::string_view target_stream,
                                     std::string_view target_attr) {
-    if (target_stream == stream_id && target_attr == interval_type)
-        throw StreamIntervalError("Self-referencing interval detected");
+    if (auto checked = check_not_recursive(stream_id, interval_type, target_stream, target_attr); !checked)
+        throw StreamIntervalError(checked.error());
 }
 
 /**
@@ -63,10 +99,8 @@ constexpr void ensure_not_recursive(std::string_view stream_id,
  * @throws StreamIntervalError if the resolved value is another unresolved interval.
  */
 constexpr void ensure_resolved_value_is_final(std::string_view resolved) {
-    if (resolved == "input_interval" ||
-        resolved == "output_interval" ||
-        resolved.starts_with("stream:"))
-        throw StreamIntervalError("Recursive or unexpandable interval reference");
+    if (auto checked = check_resolved_value_is_final(resolved); !checked)
+        throw StreamIntervalError(checked.error());
 }
 
 // ============================================================================
@@ -77,11 +111,11 @@ constexpr void ensure_resolved_value_is_final(std::string_view resolved) {
  * @brief Searches for a stream node by name and tag.
  * @return The matching node, or std::nullopt if not found.
  */
-template<XmlNode Node>
+template<XmlNodeLike Node>
 std::optional<Node> find_stream(const Node& root,
                                 std::string_view name,
                                 std::string_view tag) {
-    for (auto& child : root.children(tag)) {
+    for (const auto& child : root.children(tag)) {
         if (child.has_attribute("name") &&
             child.get_attribute("name") == name)
             return child;
@@ -89,36 +123,89 @@ std::optional<Node> find_stream(const Node& root,
     return std::nullopt;
 }
 
+namespace detail {
+
+inline StreamError missing_stream_error(std::string_view name) {
+    return {StreamErrorCode::missing_stream, std::format("Referenced stream '{}' not found", name)};
+}
+
+inline StreamError malformed_reference_error() {
+    return {StreamErrorCode::malformed_reference, "Malformed interval reference (missing ':')"};
+}
+
+inline StreamError missing_attribute_error(std::string_view attr, std::string_view stream) {
+    return {StreamErrorCode::missing_attribute,
+            std::format("Referenced attribute '{}' missing in stream '{}'", attr, stream)};
+}
+
+} // namespace detail
+
+/** @brief Non-throwing `resolve_target_stream` over the XML root. */
+template<XmlNodeLike Node>
+std::expected<Node, StreamError> try_resolve_target_stream(const Node& root, std::string_view name) {
+    if (auto s = find_stream(root, name, "immutable_stream")) return *s;
+    if (auto s = find_stream(root, name, "stream")) return *s;
+    return std::unexpected(detail::missing_stream_error(name));
+}
+
+/** @brief Non-throwing `resolve_target_stream` through an index. */
+template<XmlNodeLike Node>
+std::expected<Node, StreamError> try_resolve_target_stream(const StreamIndex<Node>& index, std::string_view name) {
+    if (const auto* s = index.find(name)) return *s;
+    return std::unexpected(detail::missing_stream_error(name));
+}
+
 /**
  * @brief Resolves a referenced stream by name from the given XML root.
  * @throws StreamIntervalError if no matching stream is found.
  */
-template<XmlNode Node>
+template<XmlNodeLike Node>
 Node resolve_target_stream(const Node& root, std::string_view name) {
-    if (auto s = find_stream(root, name, "immutable_stream")) return *s;
-    if (auto s = find_stream(root, name, "stream")) return *s;
-    throw StreamIntervalError(std::format("Referenced stream '{}' not found", name));
+    auto s = try_resolve_target_stream(root, name);
+    if (!s) throw StreamIntervalError(s.error());
+    return *std::move(s);
+}
+
+/**
+ * @brief Resolves a referenced stream by name through a prebuilt index.
+ *
+ * Constant-time alternative to the root-scanning overload, with the same
+ * precedence rules.
+ *
+ * @throws StreamIntervalError if no matching stream is found.
+ */
+template<XmlNodeLike Node>
+Node resolve_target_stream(const StreamIndex<Node>& index, std::string_view name) {
+    auto s = try_resolve_target_stream(index, name);
+    if (!s) throw StreamIntervalError(s.error());
+    return *std::move(s);
 }
 
+/**
+ * @concept StreamLookup
+ * @brief A source of stream definitions that `resolve_target_stream` accepts.
+ *
+ * Satisfied by the `<streams>` root node itself (linear scan) and by
+ * `StreamIndex` (hashed lookup).
+ */
+template<typename T>
+concept StreamLookup = requires(const T& streams, std::string_view name) {
+    resolve_target_stream(streams, name);
+};
+
 // ============================================================================
 // Stream interval extraction
 // ============================================================================
 
 /**
- * @brief Extracts and resolves an interval reference of the form "stream:other_stream:attribute".
- *
- * @param interval       The interval reference or literal value.
- * @param interval_type  The attribute type ("input_interval" or "output_interval").
- * @param stream_id      The name of the current stream.
- * @param streams_root   The XML root node containing all stream definitions.
- * @return The resolved interval value.
- * @throws StreamIntervalError on invalid, missing, or recursive references.
+ * @brief Non-throwing `extract_stream_interval`.
+ * @return The resolved interval value, or the reason it could not be resolved.
  */
-template<XmlNode Node>
-std::string extract_stream_interval(std::string_view interval,
-                                    std::string_view interval_type,
-                                    std::string_view stream_id,
-                                    const Node& streams_root) {
+template<StreamLookup Streams>
+std::expected<std::string, StreamError> try_extract_stream_interval(std::string_view interval,
+                                                                    std::string_view interval_type,
+                                                                    std::string_view stream_id,
+                                                                    const Streams& streams_root) {
     if (!interval.starts_with("stream:"))
         return std::string(interval);
 
@@ -126,38 +213,106 @@ std::string extract_stream_interval(std::string_view interval,
 
     const auto pos = interval.find(':');
     if (pos == std::string_view::npos)
-        throw StreamIntervalError("Malformed interval reference (missing ':')");
+        return std::unexpected(detail::malformed_reference_error());
 
     const auto target_stream = interval.substr(0, pos);
     const auto target_attr   = interval.substr(pos + 1);
 
-    ensure_not_recursive(stream_id, interval_type, target_stream, target_attr);
-    ensure_valid_attribute(target_attr);
-
-    const auto target = resolve_target_stream(streams_root, target_stream);
-    if (!target.has_attribute(target_attr))
-        throw StreamIntervalError(std::format(
-            "Referenced attribute '{}' missing in stream '{}'",
-            target_attr, target_stream));
+    if (auto checked = check_not_recursive(stream_id, interval_type, target_stream, target_attr); !checked)
+        return std::unexpected(std::move(checked.error()));
+    if (auto checked = check_valid_attribute(target_attr); !checked)
+        return std::unexpected(std::move(checked.error()));
+
+    const auto target = try_resolve_target_stream(streams_root, target_stream);
+    if (!target)
+        return std::unexpected(target.error());
+    if (!target->has_attribute(target_attr))
+        return std::unexpected(detail::missing_attribute_error(target_attr, target_stream));
+
+    const auto resolved = target->get_attribute(target_attr);
+    if (auto checked = check_resolved_value_is_final(resolved); !checked)
+        return std::unexpected(std::move(checked.error()));
+    return std::string(resolved);
+}
 
-    auto resolved = target.get_attribute(target_attr);
-    ensure_resolved_value_is_final(resolved);
-    return resolved;
+/**
+ * @brief Extracts and resolves an interval reference of the form "stream:other_stream:attribute".
+ *
+ * @param interval       The interval reference or literal value.
+ * @param interval_type  The attribute type ("input_interval" or "output_interval").
+ * @param stream_id      The name of the current stream.
+ * @param streams_root   The XML root node containing all stream definitions,
+ *                       or a `StreamIndex` built from it.
+ * @return The resolved interval value.
+ * @throws StreamIntervalError on invalid, missing, or recursive references.
+ */
+template<StreamLookup Streams>
+std::string extract_stream_interval(std::string_view interval,
+                                    std::string_view interval_type,
+                                    std::string_view stream_id,
+                                    const Streams& streams_root) {
+    auto resolved = try_extract_stream_interval(interval, interval_type, stream_id, streams_root);
+    if (!resolved)
+        throw StreamIntervalError(resolved.error());
+    return *std::move(resolved);
 }
 
 /**
  * @brief Wrapper around extract_stream_interval that safely handles empty intervals.
  */
-template<XmlNode Node>
+template<StreamLookup Streams>
 std::string parse_interval(std::string_view interval,
                            std::string_view interval_type,
                            std::string_view stream_id,
-                           const Node& streams) {
+                           const Streams& streams) {
     return interval.empty()
                ? std::string{}
                : extract_stream_interval(interval, interval_type, stream_id, streams);
 }
 
+/**
+ * @brief `parse_interval` writing into an existing string.
+ *
+ * `out` keeps its allocator. Literal values are copied straight in; only
+ * `stream:` references go through a temporary `std::string`.
+ */
+template<typename String, StreamLookup Streams>
+void parse_interval_into(String& out,
+                         std::string_view interval,
+                         std::string_view interval_type,
+                         std::string_view stream_id,
+                         const Streams& streams) {
+    if (!interval.starts_with("stream:"))
+        out.assign(interval);
+    else
+        out.assign(extract_stream_interval(interval, interval_type, stream_id, streams));
+}
+
+/**
+ * @brief Non-throwing `parse_interval_into`; `out` is unchanged on error.
+ *
+ * The error's `attribute` is `interval_type`, where the reference starts,
+ * however far along the chain it was found.
+ */
+template<typename String, StreamLookup Streams>
+std::expected<void, StreamError> try_parse_interval_into(String& out,
+                                                         std::string_view interval,
+                                                         std::string_view interval_type,
+                                                         std::string_view stream_id,
+                                                         const Streams& streams) {
+    if (!interval.starts_with("stream:")) {
+        out.assign(interval);
+        return {};
+    }
+    auto resolved = try_extract_stream_interval(interval, interval_type, stream_id, streams);
+    if (!resolved) {
+        resolved.error().attribute = interval_type;
+        return std::unexpected(std::move(resolved.error()));
+    }
+    out.assign(*resolved);
+    return {};
+}
+
 // ============================================================================
 // Field parsing
 // ============================================================================
@@ -166,12 +321,12 @@ std::string parse_interval(std::string_view interval,
  * @brief Extracts all attributes of an XML stream node into a string map.
  * @return A map from attribute name to value.
  */
-template<XmlNode Node>
+template<XmlNodeLike Node>
 [[nodiscard]] std::unordered_map<std::string, std::string>
 parse_fields(const Node& stream_xml) {
     std::unordered_map<std::string, std::string> fields;
     for (const auto& [key, value] : stream_xml.get_attributes())
-        fields[key] = value;
+        fields.emplace(key, value);
     return fields;
 }
 
@@ -180,19 +335,18 @@ parse_fields(const Node& stream_xml) {
 // ============================================================================
 
 /**
- * @brief Determines the correct filename interval for a stream based on direction and interval attributes.
+ * @brief Chooses a stream's filename interval from its already resolved intervals.
+ *
+ * @return A view of one of the arguments, or of the literal "none".
  *
  * @details
  * - Prefers explicit filename_interval if provided.
  * - Otherwise derives from input/output intervals according to direction.
  */
-template<XmlNode Node>
-std::string parse_filename_interval(std::string_view direction,
-                                    std::string_view interval_in,
-                                    std::string_view interval_out,
-                                    std::string_view filename_interval,
-                                    std::string_view stream_id,
-                                    const Node& streams) {
+constexpr std::string_view select_filename_interval(std::string_view direction,
+                                                    std::string_view resolved_in,
+                                                    std::string_view resolved_out,
+                                                    std::string_view filename_interval) {
     constexpr auto is_real_interval = [](std::string_view s) noexcept {
         return !s.empty() &&
                s != "initial_only" &&
@@ -200,15 +354,12 @@ std::string parse_filename_interval(std::string_view direction,
                s != "none";
     };
 
-    const auto resolved_in  = parse_interval(interval_in,  "input_interval",  stream_id, streams);
-    const auto resolved_out = parse_interval(interval_out, "output_interval", stream_id, streams);
-
     const bool for_input  = direction.contains("input");
     const bool for_output = direction.contains("output");
 
-    std::string result{filename_interval};
+    std::string_view result{filename_interval};
 
-    auto pick_interval = [&](auto a, auto b) -> std::string {
+    auto pick_interval = [&](std::string_view a, std::string_view b) -> std::string_view {
         return is_real_interval(a) ? a : (is_real_interval(b) ? b : "");
     };
 
@@ -228,11 +379,28 @@ std::string parse_filename_interval(std::string_view direction,
     return result.empty() ? "none" : result;
 }
 
+/**
+ * @brief Determines the correct filename interval for a stream based on direction and interval attributes.
+ *
+ * Resolves the raw input/output intervals and applies `select_filename_interval`.
+ */
+template<StreamLookup Streams>
+std::string parse_filename_interval(std::string_view direction,
+                                    std::string_view interval_in,
+                                    std::string_view interval_out,
+                                    std::string_view filename_interval,
+                                    std::string_view stream_id,
+                                    const Streams& streams) {
+    const auto resolved_in  = parse_interval(interval_in,  "input_interval",  stream_id, streams);
+    const auto resolved_out = parse_interval(interval_out, "output_interval", stream_id, streams);
+    return std::string(select_filename_interval(direction, resolved_in, resolved_out, filename_interval));
+}
+
 // ============================================================================
 // Attribute parsing utilities
 // ============================================================================
 
-/// Parses the clobber mode attribute into an integer code.
+/// Parses the clobber mode attribute into an integer code, by substring; see `classify_clobber_mode`.
 constexpr int parse_clobber_mode(std::string_view s) noexcept {
     if (s.contains("never_modify"))   return 0;
     if (s.contains("append"))         return 1;
@@ -241,7 +409,7 @@ constexpr int parse_clobber_mode(std::string_view s) noexcept {
     return 0;
 }
 
-/// Parses the I/O type string into an integer code.
+/// Parses the I/O type string into an integer code, by substring; see `classify_io_type`.
 constexpr int parse_io_type(std::string_view s) noexcept {
     if (s.contains("pnetcdf,cdf5")) return 1;
     if (s.contains("pnetcdf"))      return 0;
@@ -250,7 +418,7 @@ constexpr int parse_io_type(std::string_view s) noexcept {
     return 0;
 }
 
-/// Parses the direction ("input", "output", or both) into an integer code.
+/// Parses the direction ("input", "output", or both) into an integer code, by substring; see `classify_direction`.
 constexpr int parse_direction(std::string_view dir) noexcept {
     const bool in  = dir.contains("input");
     const bool out = dir.contains("output");
@@ -270,7 +438,8 @@ constexpr std::string_view parse_record_interval(std::string_view rec) noexcept
     return rec.empty() ? "none" : rec;
 }
 
-/// Parses the precision attribute into byte width (4 for single, 8 for double).
+/// Parses the precision attribute into byte width (4 for single, 8 for double), by substring;
+/// see `classify_precision`.
 constexpr int parse_precision_bytes(std::string_view precision) noexcept {
     if (precision.contains("single")) return 4;
     if (precision.contains("double")) return 8;
@@ -287,17 +456,21 @@ constexpr int parse_precision_bytes(std::string_view precision) noexcept {
  */
 inline void build_stream_path(IXmlFileSystem& fs,
                               std::string_view filename_template) {
+    const PhaseTimer timer{LoadPhase::path_handling};
     const auto dir = std::filesystem::path(filename_template).parent_path();
     if (dir.empty()) return;
 
     const auto dir_str = dir.string();
-    if (!fs.exists(dir_str) && !fs.create_directories(dir_str))
-        throw std::runtime_error(std::format(
-            "Failed to create directory '{}'", dir_str));
-
-    if (!fs.can_write(dir_str))
-        throw std::runtime_error(std::format(
-            "Directory '{}' is not writable", dir_str));
+    switch (fs.ensure_writable_directory(dir_str)) {
+        case DirectoryStatus::writable:
+            return;
+        case DirectoryStatus::create_failed:
+            throw std::runtime_error(std::format(
+                "Failed to create directory '{}'", dir_str));
+        case DirectoryStatus::not_writable:
+            throw std::runtime_error(std::format(
+                "Directory '{}' is not writable", dir_str));
+    }
 }
 
 /**
@@ -311,6 +484,65 @@ inline void handle_stream_output_path(IXmlFileSystem& fs,
         build_stream_path(fs, filename_template);
 }
 
+// ============================================================================
+// Polymorphic-allocator variants
+// ============================================================================
+
+/**
+ * Variants of the parse helpers whose results are allocated from a
+ * caller-supplied `std::pmr::memory_resource`, typically a per-document
+ * `std::pmr::monotonic_buffer_resource`.
+ */
+namespace pmr {
+
+/**
+ * @brief `xml_stream_parser::parse_fields` allocating from `resource`.
+ */
+template<XmlNodeLike Node>
+[[nodiscard]] std::pmr::unordered_map<std::pmr::string, std::pmr::string>
+parse_fields(const Node& stream_xml,
+             std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    std::pmr::unordered_map<std::pmr::string, std::pmr::string> fields{resource};
+    for (const auto& [key, value] : stream_xml.get_attributes())
+        fields.emplace(std::string_view{key}, std::string_view{value});
+    return fields;
+}
+
+/**
+ * @brief `xml_stream_parser::parse_interval` allocating from `resource`.
+ */
+template<StreamLookup Streams>
+[[nodiscard]] std::pmr::string
+parse_interval(std::string_view interval,
+               std::string_view interval_type,
+               std::string_view stream_id,
+               const Streams& streams,
+               std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    std::pmr::string result{resource};
+    parse_interval_into(result, interval, interval_type, stream_id, streams);
+    return result;
+}
+
+/**
+ * @brief `xml_stream_parser::parse_filename_interval` allocating from `resource`.
+ */
+template<StreamLookup Streams>
+[[nodiscard]] std::pmr::string
+parse_filename_interval(std::string_view direction,
+                        std::string_view interval_in,
+                        std::string_view interval_out,
+                        std::string_view filename_interval,
+                        std::string_view stream_id,
+                        const Streams& streams,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    const auto resolved_in  = pmr::parse_interval(interval_in,  "input_interval",  stream_id, streams, resource);
+    const auto resolved_out = pmr::parse_interval(interval_out, "output_interval", stream_id, streams, resource);
+    return std::pmr::string{
+        select_filename_interval(direction, resolved_in, resolved_out, filename_interval), resource};
+}
+
+} // namespace pmr
+
 } // namespace xml_stream_parser
 
 #endif // XML_STREAM_PARSER_PARSE_HPP
@@ -2,11 +2,15 @@
 #ifndef XML_STREAM_PARSER_XML_PARSER_CONCEPTS_HPP
 #define XML_STREAM_PARSER_XML_PARSER_CONCEPTS_HPP
 
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <unordered_map>
+#include <utility>
 #include <concepts>
+#include <ranges>
 
 namespace xml_stream_parser {
 
@@ -71,6 +75,92 @@ concept XmlNode = requires(const T& node,
         -> std::convertible_to<std::unordered_map<std::string, std::string>>;
 };
 
+/**
+ * @concept XmlNodeView
+ * @brief A non-owning, allocation-free variant of the `XmlNode` interface.
+ *
+ * Backends whose attribute and element names live in stable storage (such as
+ * a pugixml document) can hand out views into that storage instead of
+ * copies. A type `T` satisfies `XmlNodeView` if it supports:
+ *
+ * - Retrieving a single attribute by name:
+ *   `std::string_view get_attribute(std::string_view)`
+ *
+ * - Checking existence of an attribute:
+ *   `bool has_attribute(std::string_view)`
+ *
+ * - Lazily iterating child nodes with a given tag name:
+ *   an input range of `T` returned by `children(std::string_view)`
+ *
+ * - Getting the node's element name:
+ *   `std::string_view name()`
+ *
+ * - Lazily iterating all attributes:
+ *   an input range of `std::pair<std::string_view, std::string_view>`
+ *   returned by `get_attributes()`
+ *
+ * Returned views are valid for the lifetime of the underlying document.
+ */
+template<typename T>
+concept XmlNodeView = requires(const T& node,
+                               std::string_view key,
+                               std::string_view tag)
+{
+    /// Must return a view of the attribute value or an empty view.
+    { node.get_attribute(key) }
+        -> std::same_as<std::string_view>;
+
+    /// Must return whether the attribute exists.
+    { node.has_attribute(key) }
+        -> std::convertible_to<bool>;
+
+    /// Must return a lazy range of child XML nodes.
+    { node.children(tag) }
+        -> std::ranges::input_range;
+    requires std::same_as<
+        std::ranges::range_value_t<decltype(node.children(tag))>, T>;
+
+    /// Must return a view of the node element name.
+    { node.name() }
+        -> std::convertible_to<std::string_view>;
+
+    /// Must return a lazy range of key/value attribute views.
+    { node.get_attributes() }
+        -> std::ranges::input_range;
+    requires std::convertible_to<
+        std::ranges::range_value_t<decltype(node.get_attributes())>,
+        std::pair<std::string_view, std::string_view>>;
+};
+
+/**
+ * @concept XmlNodeLike
+ * @brief Any XML node adapter accepted by the parser: owning or view-based.
+ */
+template<typename T>
+concept XmlNodeLike = XmlNode<T> || XmlNodeView<T>;
+
+/**
+ * @concept XmlNodeWithOffset
+ * @brief A node adapter that knows where its element starts in the source text.
+ *
+ * Optional; used only to locate diagnostics.
+ */
+template<typename T>
+concept XmlNodeWithOffset = requires(const T& node) {
+    /// Must return the byte offset of the element name, or std::nullopt if unknown.
+    { node.source_offset() }
+        -> std::same_as<std::optional<std::size_t>>;
+};
+
+/** @return The node's source offset, or std::nullopt if the adapter does not report one. */
+template<XmlNodeLike Node>
+[[nodiscard]] std::optional<std::size_t> source_offset(const Node& node) noexcept {
+    if constexpr (XmlNodeWithOffset<Node>)
+        return node.source_offset();
+    else
+        return std::nullopt;
+}
+
 /** @} */ // end of xml_concepts
 
 } // namespace xml_stream_parser
@@ -2,6 +2,8 @@
 #ifndef XML_STREAM_PARSER_XML_NODE_HPP
 #define XML_STREAM_PARSER_XML_NODE_HPP
 
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -89,8 +91,11 @@ public:
      */
     [[nodiscard]] std::vector<PugiXmlAdapter>
     children(std::string_view tag) const {
+        // pugixml's named child range keeps a pointer to the tag, so the
+        // null-terminated copy must outlive the loop.
+        const std::string tag_str{tag};
         std::vector<PugiXmlAdapter> result;
-        for (const auto& child : node_.children(std::string{tag}.c_str()))
+        for (const auto& child : node_.children(tag_str.c_str()))
             result.emplace_back(child);
         return result;
     }
@@ -104,6 +109,18 @@ public:
         return node_.name();
     }
 
+    /**
+     * @brief Retrieves the byte offset of the element name in the parsed buffer.
+     *
+     * @return The offset, or std::nullopt for nodes not parsed from text.
+     */
+    [[nodiscard]] std::optional<std::size_t> source_offset() const noexcept {
+        const auto offset = node_.offset_debug();
+        if (offset < 0)
+            return std::nullopt;
+        return static_cast<std::size_t>(offset);
+    }
+
 private:
     /// The underlying PugiXML node being adapted.
     pugi::xml_node node_;
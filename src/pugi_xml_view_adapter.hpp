@@ -0,0 +1,204 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_PUGI_XML_VIEW_ADAPTER_HPP
+#define XML_STREAM_PARSER_PUGI_XML_VIEW_ADAPTER_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <pugixml.hpp>
+
+namespace xml_stream_parser {
+
+/**
+ * @class PugiXmlViewAdapter
+ * @brief A non-owning wrapper around `pugi::xml_node` satisfying `XmlNodeView`.
+ *
+ * Unlike `PugiXmlAdapter`, no call on this adapter allocates:
+ *  - Attribute names and values are returned as views into the document.
+ *  - Attribute lookup compares against the string view directly, without
+ *    building a null-terminated copy of the key.
+ *  - Children and attributes are exposed as lazy ranges walked on demand.
+ *
+ * All returned views and ranges are valid for the lifetime of the underlying
+ * `pugi::xml_document`. A range returned by `children(tag)` additionally
+ * refers to `tag`, which must outlive the range.
+ */
+class PugiXmlViewAdapter {
+public:
+    /**
+     * @class ChildIterator
+     * @brief Forward iterator over the sibling elements that carry a given name.
+     */
+    class ChildIterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type       = PugiXmlViewAdapter;
+        using difference_type  = std::ptrdiff_t;
+
+        ChildIterator() = default;
+
+        ChildIterator(pugi::xml_node first, std::string_view tag) noexcept
+            : node_{first}, tag_{tag} { skip_mismatches(); }
+
+        [[nodiscard]] value_type operator*() const noexcept {
+            return PugiXmlViewAdapter{node_};
+        }
+
+        ChildIterator& operator++() noexcept {
+            node_ = node_.next_sibling();
+            skip_mismatches();
+            return *this;
+        }
+
+        ChildIterator operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        [[nodiscard]] bool operator==(const ChildIterator& other) const noexcept {
+            return node_ == other.node_;
+        }
+
+        [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept {
+            return !node_;
+        }
+
+    private:
+        void skip_mismatches() noexcept {
+            while (node_ && tag_ != node_.name())
+                node_ = node_.next_sibling();
+        }
+
+        pugi::xml_node node_;
+        std::string_view tag_;
+    };
+
+    /**
+     * @class AttributeIterator
+     * @brief Forward iterator yielding `(name, value)` views of each attribute.
+     */
+    class AttributeIterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type       = std::pair<std::string_view, std::string_view>;
+        using difference_type  = std::ptrdiff_t;
+
+        AttributeIterator() = default;
+
+        explicit AttributeIterator(pugi::xml_attribute first) noexcept : attr_{first} {}
+
+        [[nodiscard]] value_type operator*() const noexcept {
+            return {attr_.name(), attr_.value()};
+        }
+
+        AttributeIterator& operator++() noexcept {
+            attr_ = attr_.next_attribute();
+            return *this;
+        }
+
+        AttributeIterator operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        [[nodiscard]] bool operator==(const AttributeIterator& other) const noexcept {
+            return attr_ == other.attr_;
+        }
+
+        [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept {
+            return !attr_;
+        }
+
+    private:
+        pugi::xml_attribute attr_;
+    };
+
+    using attribute_range = std::ranges::subrange<AttributeIterator, std::default_sentinel_t>;
+
+    /**
+     * @brief Constructs an adapter around a PugiXML node.
+     * @param n The underlying PugiXML node.
+     */
+    explicit PugiXmlViewAdapter(pugi::xml_node n) noexcept : node_{n} {}
+
+    /**
+     * @brief Retrieves a view of an attribute's value by name.
+     *
+     * @param key The attribute name (case-sensitive).
+     * @return The attribute's value, or an empty view if missing.
+     */
+    [[nodiscard]] std::string_view get_attribute(std::string_view key) const noexcept {
+        if (const auto attr = find_attribute(key))
+            return attr.value();
+        return {};
+    }
+
+    /**
+     * @brief Returns a lazy range over all attributes of this node.
+     */
+    [[nodiscard]] attribute_range get_attributes() const noexcept {
+        return {AttributeIterator{node_.first_attribute()}, std::default_sentinel};
+    }
+
+    /**
+     * @brief Checks whether this XML node has a specific attribute.
+     *
+     * @param key The attribute name.
+     * @return True if the attribute exists, false otherwise.
+     */
+    [[nodiscard]] bool has_attribute(std::string_view key) const noexcept {
+        return static_cast<bool>(find_attribute(key));
+    }
+
+    /**
+     * @brief Returns a lazy range over child nodes with the given tag name.
+     *
+     * @param tag The child element name; must outlive the returned range.
+     */
+    [[nodiscard]] auto children(std::string_view tag) const noexcept;
+
+    /**
+     * @brief Returns a view of the element name of this XML node.
+     */
+    [[nodiscard]] std::string_view name() const noexcept {
+        return node_.name();
+    }
+
+    /**
+     * @brief Returns the byte offset of the element name in the parsed buffer.
+     *
+     * Unknown (std::nullopt) for nodes that were not parsed from text.
+     */
+    [[nodiscard]] std::optional<std::size_t> source_offset() const noexcept {
+        const auto offset = node_.offset_debug();
+        if (offset < 0)
+            return std::nullopt;
+        return static_cast<std::size_t>(offset);
+    }
+
+private:
+    [[nodiscard]] pugi::xml_attribute find_attribute(std::string_view key) const noexcept {
+        for (auto attr = node_.first_attribute(); attr; attr = attr.next_attribute())
+            if (key == attr.name())
+                return attr;
+        return {};
+    }
+
+    /// The underlying PugiXML node being adapted.
+    pugi::xml_node node_;
+};
+
+// Defined out of line: the range type needs `PugiXmlViewAdapter` to be complete.
+inline auto PugiXmlViewAdapter::children(std::string_view tag) const noexcept {
+    return std::ranges::subrange<ChildIterator, std::default_sentinel_t>{
+        ChildIterator{node_.first_child(), tag}, std::default_sentinel};
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_PUGI_XML_VIEW_ADAPTER_HPP
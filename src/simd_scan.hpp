@@ -0,0 +1,244 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_SIMD_SCAN_HPP
+#define XML_STREAM_PARSER_SIMD_SCAN_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define XML_STREAM_PARSER_SIMD_X86 1
+#endif
+
+namespace xml_stream_parser {
+
+/**
+ * @defgroup simd_scan SIMD Byte Scanning
+ * @brief Vectorized searches for small sets of delimiter bytes.
+ *
+ * The tokenizer's inner loops look for one of a handful of bytes (`<`,
+ * `>`, `=`, quotes, whitespace). These helpers compare 16 (SSE2) or 32
+ * (AVX2) bytes per step against every byte of the set at once. The
+ * instruction set is chosen at runtime from what the CPU supports; other
+ * architectures use the scalar loop.
+ * @{
+ */
+
+/**
+ * @brief Instruction sets a scan can run with, from slowest to fastest.
+ */
+enum class SimdLevel : std::uint8_t { scalar, sse2, avx2 };
+
+/** @return The fastest level supported by this CPU. */
+[[nodiscard]] inline SimdLevel supported_simd_level() noexcept {
+#ifdef XML_STREAM_PARSER_SIMD_X86
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return SimdLevel::avx2;
+        if (__builtin_cpu_supports("sse2"))
+            return SimdLevel::sse2;
+        return SimdLevel::scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::scalar;
+#endif
+}
+
+namespace detail {
+
+inline std::atomic<SimdLevel>& simd_level_setting() noexcept {
+    static std::atomic<SimdLevel> level{supported_simd_level()};
+    return level;
+}
+
+} // namespace detail
+
+/** @return The level scans currently use. */
+[[nodiscard]] inline SimdLevel simd_level() noexcept {
+    return detail::simd_level_setting().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Selects the level scans use, e.g. to compare levels in a benchmark.
+ *
+ * Requests above `supported_simd_level()` are lowered to it.
+ * @return The level now in use.
+ */
+inline SimdLevel set_simd_level(SimdLevel level) noexcept {
+    if (level > supported_simd_level())
+        level = supported_simd_level();
+    detail::simd_level_setting().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+namespace detail {
+
+/// Whether `c` is in the set, or, if `Negate`, whether it is not.
+template<bool Negate, char... Set>
+constexpr bool scan_matches(char c) noexcept {
+    return ((c == Set) || ...) != Negate;
+}
+
+template<bool Negate, char... Set>
+std::size_t scan_scalar(const char* data, std::size_t size, std::size_t pos) noexcept {
+    for (; pos < size; ++pos)
+        if (scan_matches<Negate, Set...>(data[pos]))
+            return pos;
+    return std::string_view::npos;
+}
+
+#ifdef XML_STREAM_PARSER_SIMD_X86
+
+/// Bit `i` set if byte `i` of the 16 at `data` matches.
+template<bool Negate, char... Set>
+[[gnu::target("sse2")]] std::uint32_t match_mask_16(const char* data) noexcept {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i hits = _mm_setzero_si128();
+    ((hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Set)))), ...);
+    auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+    if constexpr (Negate)
+        mask = ~mask & 0xFFFFu;
+    return mask;
+}
+
+template<bool Negate, char... Set>
+[[gnu::target("sse2")]] std::size_t scan_sse2(const char* data, std::size_t size, std::size_t pos) noexcept {
+    for (; pos + 16 <= size; pos += 16)
+        if (const auto mask = match_mask_16<Negate, Set...>(data + pos); mask != 0)
+            return pos + static_cast<std::size_t>(__builtin_ctz(mask));
+    return scan_scalar<Negate, Set...>(data, size, pos);
+}
+
+/**
+ * Most tokens are shorter than 16 bytes, so one 16-byte probe precedes the
+ * 32-byte loop; wide loads only pay off on long runs such as comments.
+ */
+template<bool Negate, char... Set>
+[[gnu::target("avx2")]] std::size_t scan_avx2(const char* data, std::size_t size, std::size_t pos) noexcept {
+    if (pos + 16 <= size) {
+        if (const auto mask = match_mask_16<Negate, Set...>(data + pos); mask != 0)
+            return pos + static_cast<std::size_t>(__builtin_ctz(mask));
+        pos += 16;
+    }
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i hits = _mm256_setzero_si256();
+        ((hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(Set)))), ...);
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+        if constexpr (Negate)
+            mask = ~mask;
+        if (mask != 0)
+            return pos + static_cast<std::size_t>(__builtin_ctz(mask));
+    }
+    return scan_sse2<Negate, Set...>(data, size, pos);
+}
+
+#endif
+
+template<char... Set, typename F>
+std::size_t visit_scalar(const char* data, std::size_t size, std::size_t pos, F& f) {
+    for (; pos < size; ++pos)
+        if (scan_matches<false, Set...>(data[pos]) && !f(pos))
+            return pos;
+    return std::string_view::npos;
+}
+
+#ifdef XML_STREAM_PARSER_SIMD_X86
+
+template<char... Set, typename F>
+[[gnu::target("sse2")]] std::size_t visit_sse2(const char* data, std::size_t size, std::size_t pos, F& f) {
+    for (; pos + 16 <= size; pos += 16) {
+        for (auto mask = match_mask_16<false, Set...>(data + pos); mask != 0; mask &= mask - 1) {
+            const auto at = pos + static_cast<std::size_t>(__builtin_ctz(mask));
+            if (!f(at))
+                return at;
+        }
+    }
+    return visit_scalar<Set...>(data, size, pos, f);
+}
+
+template<char... Set, typename F>
+[[gnu::target("avx2")]] std::size_t visit_avx2(const char* data, std::size_t size, std::size_t pos, F& f) {
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i hits = _mm256_setzero_si256();
+        ((hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(Set)))), ...);
+        for (auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits)); mask != 0; mask &= mask - 1) {
+            const auto at = pos + static_cast<std::size_t>(__builtin_ctz(mask));
+            if (!f(at))
+                return at;
+        }
+    }
+    return visit_sse2<Set...>(data, size, pos, f);
+}
+
+#endif
+
+template<bool Negate, char... Set>
+std::size_t scan(std::string_view text, std::size_t pos) noexcept {
+    if (pos >= text.size())
+        return std::string_view::npos;
+#ifdef XML_STREAM_PARSER_SIMD_X86
+    switch (simd_level()) {
+        case SimdLevel::avx2:   return scan_avx2<Negate, Set...>(text.data(), text.size(), pos);
+        case SimdLevel::sse2:   return scan_sse2<Negate, Set...>(text.data(), text.size(), pos);
+        case SimdLevel::scalar: break;
+    }
+#endif
+    return scan_scalar<Negate, Set...>(text.data(), text.size(), pos);
+}
+
+} // namespace detail
+
+/**
+ * @brief Finds the first byte at or after `pos` that is one of `Set`.
+ * @return Its position, or `npos`.
+ */
+template<char... Set>
+[[nodiscard]] std::size_t find_any_of(std::string_view text, std::size_t pos = 0) noexcept {
+    return detail::scan<false, Set...>(text, pos);
+}
+
+/**
+ * @brief Finds the first byte at or after `pos` that is none of `Set`.
+ * @return Its position, or `npos`.
+ */
+template<char... Set>
+[[nodiscard]] std::size_t find_none_of(std::string_view text, std::size_t pos = 0) noexcept {
+    return detail::scan<true, Set...>(text, pos);
+}
+
+/**
+ * @brief Calls `f(i)` for every position `i >= pos` whose byte is one of
+ *        `Set`, in order, until `f` returns false.
+ *
+ * Unlike repeated `find_any_of` calls, each block of input is loaded and
+ * compared once however many matches it holds, which suits inputs dense
+ * with short tokens.
+ *
+ * @return The position at which `f` returned false, or `npos` if the input
+ *         was exhausted.
+ */
+template<char... Set, typename F>
+std::size_t for_each_of(std::string_view text, std::size_t pos, F&& f) {
+    if (pos >= text.size())
+        return std::string_view::npos;
+#ifdef XML_STREAM_PARSER_SIMD_X86
+    switch (simd_level()) {
+        case SimdLevel::avx2:   return detail::visit_avx2<Set...>(text.data(), text.size(), pos, f);
+        case SimdLevel::sse2:   return detail::visit_sse2<Set...>(text.data(), text.size(), pos, f);
+        case SimdLevel::scalar: break;
+    }
+#endif
+    return detail::visit_scalar<Set...>(text.data(), text.size(), pos, f);
+}
+
+/** @} */ // end of simd_scan
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_SIMD_SCAN_HPP
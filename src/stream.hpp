@@ -2,12 +2,44 @@
 #ifndef XML_STREAM_PARSER_STREAM_HPP
 #define XML_STREAM_PARSER_STREAM_HPP
 
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <utility>
+#include "filename_template.hpp"
+#include "instrumentation.hpp"
+#include "interval.hpp"
 #include "parse.hpp"
+#include "string_pool.hpp"
+#include "stream_attributes.hpp"
+#include "stream_keywords.hpp"
+#include "stream_members.hpp"
 
 namespace xml_stream_parser {
 
+namespace detail {
+
+/// Throws the exception the throwing load path has always used for `error`.
+[[noreturn]] inline void throw_stream_error(const StreamError& error) {
+    switch (error.code) {
+        case StreamErrorCode::unknown_keyword:
+        case StreamErrorCode::conflicting_keywords:
+            throw StreamKeywordError(error);
+        case StreamErrorCode::unnamed_member:
+            throw std::runtime_error(error.message);
+        default:
+            throw StreamIntervalError(error);
+    }
+}
+
+} // namespace detail
+
 /**
  * @brief Returns the value associated with a key in a map or a default value if the key is missing.
  *
@@ -34,7 +66,33 @@ auto get_or(const Map& m,
 }
 
 /**
- * @class Stream
+ * @brief The resolved values of one stream, independent of any XML backend.
+ *
+ * Used to move streams in and out of non-XML representations such as the
+ * binary stream cache. String members are views; their lifetime is that of
+ * whatever they were taken from.
+ */
+struct StreamValues {
+    std::string_view stream_id;
+    std::string_view filename_template;
+    std::string_view filename_interval;
+    std::string_view input_interval;
+    std::string_view output_interval;
+    std::string_view reference_time;
+    std::string_view record_interval;
+
+    /// Member list in the form of `BasicStreamMembers::encoded()`.
+    std::string_view members;
+
+    int type{0};
+    int immutable{0};
+    int precision{0};
+    int clobber_mode{0};
+    int iotype{0};
+};
+
+/**
+ * @class BasicStream
  * @brief Represents a parsed MPAS XML stream element.
  *
  * This class extracts and stores the attributes associated with a single
@@ -49,47 +107,189 @@ auto get_or(const Map& m,
  * the node representing the stream and the XML document root for resolving
  * interval references of the form `"stream:other:input_interval"`.
  *
- * @tparam Node XML node adapter type satisfying the `XmlNode` concept.
+ * All string members use `Allocator`. With `std::pmr::polymorphic_allocator`
+ * (`pmr::Stream`) every stream of a document can live in one arena, such as
+ * a `std::pmr::monotonic_buffer_resource`, and be released at once. With
+ * `InterningAllocator` every string is an `InternedString` shared through a
+ * `StringPool`.
+ *
+ * @tparam Node      XML node adapter type satisfying the `XmlNodeLike` concept.
+ * @tparam Allocator Allocator for the stream's strings.
  */
-template<XmlNode Node>
-class Stream {
+template<XmlNodeLike Node, typename Allocator = std::allocator<char>>
+class BasicStream {
 public:
-    Stream() = default;
+    using allocator_type = Allocator;
+    using string_type    = stream_string_t<Allocator>;
+    using template_type  = BasicFilenameTemplate<Allocator>;
+    using members_type   = BasicStreamMembers<Allocator>;
+
+    BasicStream() = default;
+
+    /** @param alloc Allocator for every string the stream stores. */
+    explicit BasicStream(const Allocator& alloc) noexcept
+        : m_stream_id{alloc},
+          m_filename_template{alloc},
+          m_filename_interval{alloc},
+          m_input_interval{alloc},
+          m_output_interval{alloc},
+          m_reference_time{alloc},
+          m_record_interval{alloc},
+          m_members{alloc} {}
+
+    BasicStream(const BasicStream&) = default;
+    BasicStream(BasicStream&&) noexcept = default;
+    BasicStream& operator=(const BasicStream&) = default;
+    BasicStream& operator=(BasicStream&&) = default;
+
+    /** @brief Copies `other` into storage from `alloc` (uses-allocator construction). */
+    BasicStream(const BasicStream& other, const Allocator& alloc)
+        : BasicStream{alloc} {
+        *this = other;
+    }
+
+    /** @brief Moves `other` into storage from `alloc`; copies if the allocators differ. */
+    BasicStream(BasicStream&& other, const Allocator& alloc)
+        : BasicStream{alloc} {
+        *this = std::move(other);
+    }
 
     /**
      * @brief Loads all stream metadata from the given XML node.
      *
      * This performs:
-     * - Attribute lookup (using `parse_fields`)
-     * - Default fallback handling (via `get_or`)
+     * - A single pass over the attributes into a fixed-slot table (`parse_stream_attributes`)
+     * - Default fallback handling (absent attributes read as empty)
      * - Interval resolution (via `parse_interval` / `parse_filename_interval`)
-     * - Conversion of attributes into typed values (`parse_direction`, etc.)
+     * - Conversion of attributes into typed values (`parse_direction`, etc., or
+     *   `classify_direction`, etc. when `keywords` is strict)
+     * - Collection of the `<file>`, `<var>`, `<var_array>`, `<var_struct>` and
+     *   `<stream>` children into the member list (`get_members`)
      *
      * @param stream_xml   The XML node containing stream attributes.
-     * @param streams_root The XML document root used for cross-stream resolution.
+     * @param streams_root The XML document root used for cross-stream resolution,
+     *                     or a `StreamIndex` built from it.
+     * @param keywords     How `type`, `io_type`, `clobber_mode` and `precision` are read.
+     * @throws StreamIntervalError on an invalid interval or interval reference.
+     * @throws StreamKeywordError on an unknown or conflicting keyword in strict mode.
+     * @throws std::runtime_error if a member element has no name.
      */
-    void load_from_xml(const Node& stream_xml, const Node& streams_root) {
-        const auto fields = parse_fields(stream_xml);
-
-        m_stream_id         = get_or(fields, "name", "");
-        m_type              = parse_direction(get_or(fields, "type", ""));
-        m_reference_time    = parse_reference_time(get_or(fields, "reference_time", ""));
-        m_record_interval   = parse_record_interval(get_or(fields, "record_interval", ""));
-        m_precision         = parse_precision_bytes(get_or(fields, "precision", ""));
-
-        m_filename_interval = parse_filename_interval(
-            get_or(fields, "type", ""),
-            get_or(fields, "input_interval", ""),
-            get_or(fields, "output_interval", ""),
-            get_or(fields, "filename_interval", ""),
-            m_stream_id,
-            streams_root
-        );
+    template<StreamLookup Streams>
+    void load_from_xml(const Node& stream_xml, const Streams& streams_root,
+                       KeywordParsing keywords = KeywordParsing::permissive) {
+        if (auto loaded = try_load_from_xml(stream_xml, streams_root, keywords); !loaded)
+            detail::throw_stream_error(loaded.error());
+    }
+
+    /**
+     * @brief Non-throwing `load_from_xml`.
+     *
+     * Performs the same steps and stops at the same first error, which is
+     * returned instead of thrown. On error the stream is partly loaded and
+     * should be discarded.
+     *
+     * @return The error, with `attribute` naming the attribute or member tag at fault.
+     */
+    template<StreamLookup Streams>
+    std::expected<void, StreamError> try_load_from_xml(const Node& stream_xml, const Streams& streams_root,
+                                                       KeywordParsing keywords = KeywordParsing::permissive) {
+        using enum StreamAttribute;
+        PhaseTimer timer{LoadPhase::fields};
+        const auto fields = parse_stream_attributes(stream_xml);
+        m_stream_id         = fields[name];
 
-        m_iotype            = parse_io_type(get_or(fields, "io_type", ""));
-        m_filename_template = get_or(fields, "filename_template", "");
+        timer.next(LoadPhase::enum_parsing);
+        if (keywords == KeywordParsing::strict) {
+            std::optional<StreamError> error;
+            auto code = [&](auto classified) {
+                if (classified)
+                    return static_cast<int>(std::to_underlying(*classified));
+                if (!error)
+                    error = std::move(classified.error());
+                return 0;
+            };
+            m_type          = code(try_classify_direction(fields[type], m_stream_id));
+            m_precision     = code(try_classify_precision(fields[precision], m_stream_id));
+            m_iotype        = code(try_classify_io_type(fields[io_type], m_stream_id));
+            m_clobber_mode  = code(try_classify_clobber_mode(fields[clobber_mode], m_stream_id));
+            if (error)
+                return std::unexpected(std::move(*error));
+        } else {
+            m_type          = parse_direction(fields[type]);
+            m_precision     = parse_precision_bytes(fields[precision]);
+            m_iotype        = parse_io_type(fields[io_type]);
+            m_clobber_mode  = parse_clobber_mode(fields[clobber_mode]);
+        }
+        m_reference_time    = parse_reference_time(fields[reference_time]);
+        m_record_interval   = parse_record_interval(fields[record_interval]);
         m_immutable         = (stream_xml.name() == "immutable_stream") ? 1 : 0;
-        m_clobber_mode      = parse_clobber_mode(get_or(fields, "clobber_mode", ""));
+
+        timer.next(LoadPhase::interval_resolution);
+        if (auto resolved = try_parse_interval_into(m_input_interval, fields[input_interval], "input_interval",
+                                                    m_stream_id, streams_root); !resolved)
+            return resolved;
+        if (auto resolved = try_parse_interval_into(m_output_interval, fields[output_interval], "output_interval",
+                                                    m_stream_id, streams_root); !resolved)
+            return resolved;
+        m_filename_interval = select_filename_interval(
+            fields[type],
+            m_input_interval,
+            m_output_interval,
+            fields[filename_interval]
+        );
+        if (auto parsed = try_parse_intervals(); !parsed)
+            return parsed;
+
+        timer.next(LoadPhase::members);
+        if (auto members = m_members.try_load_from_xml(stream_xml, m_stream_id); !members)
+            return members;
+
+        timer.next(LoadPhase::path_handling);
+        m_filename_template = template_type{fields[filename_template], get_allocator()};
+        return {};
+    }
+
+    /**
+     * @brief Restores previously resolved values without touching any XML.
+     * @param values Values produced by `values()` or read from a stream cache.
+     * @throws StreamIntervalError if an interval value is malformed.
+     * @throws std::runtime_error if the member list is malformed.
+     */
+    void restore(const StreamValues& values) {
+        m_stream_id         = values.stream_id;
+        m_filename_template = template_type{values.filename_template, get_allocator()};
+        m_filename_interval = values.filename_interval;
+        m_input_interval    = values.input_interval;
+        m_output_interval   = values.output_interval;
+        m_reference_time    = values.reference_time;
+        m_record_interval   = values.record_interval;
+        m_members.restore(values.members, values.stream_id);
+        m_type              = values.type;
+        m_immutable         = values.immutable;
+        m_precision         = values.precision;
+        m_clobber_mode      = values.clobber_mode;
+        m_iotype            = values.iotype;
+
+        parse_intervals();
+    }
+
+    /** @return Views of this stream's resolved values; valid while the stream is unchanged. */
+    [[nodiscard]] StreamValues values() const noexcept {
+        return {
+            .stream_id         = m_stream_id,
+            .filename_template = m_filename_template.pattern(),
+            .filename_interval = m_filename_interval,
+            .input_interval    = m_input_interval,
+            .output_interval   = m_output_interval,
+            .reference_time    = m_reference_time,
+            .record_interval   = m_record_interval,
+            .members           = m_members.encoded(),
+            .type              = m_type,
+            .immutable         = m_immutable,
+            .precision         = m_precision,
+            .clobber_mode      = m_clobber_mode,
+            .iotype            = m_iotype,
+        };
     }
 
     // -------------------------------------------------------------------------
@@ -97,30 +297,70 @@ public:
     // -------------------------------------------------------------------------
 
     /** @return The unique stream identifier. */
-    [[nodiscard]] constexpr const std::string& get_stream_id() const noexcept {
+    [[nodiscard]] constexpr const string_type& get_stream_id() const noexcept {
         return m_stream_id;
     }
 
     /** @return The filename template for output files. */
-    [[nodiscard]] constexpr const std::string& get_filename_template() const noexcept {
+    [[nodiscard]] constexpr const string_type& get_filename_template() const noexcept {
+        return m_filename_template.pattern();
+    }
+
+    /** @return The filename template compiled for allocation-free expansion. */
+    [[nodiscard]] constexpr const template_type& get_compiled_filename_template() const noexcept {
         return m_filename_template;
     }
 
     /** @return The computed filename interval. */
-    [[nodiscard]] constexpr const std::string& get_filename_interval() const noexcept {
+    [[nodiscard]] constexpr const string_type& get_filename_interval() const noexcept {
         return m_filename_interval;
     }
 
+    /** @return The resolved input interval, or empty if the stream has none. */
+    [[nodiscard]] constexpr const string_type& get_input_interval() const noexcept {
+        return m_input_interval;
+    }
+
+    /** @return The resolved output interval, or empty if the stream has none. */
+    [[nodiscard]] constexpr const string_type& get_output_interval() const noexcept {
+        return m_output_interval;
+    }
+
+    /** @return The filename interval, parsed. */
+    [[nodiscard]] constexpr const Interval& get_parsed_filename_interval() const noexcept {
+        return m_parsed_filename_interval;
+    }
+
+    /** @return The record interval, parsed. */
+    [[nodiscard]] constexpr const Interval& get_parsed_record_interval() const noexcept {
+        return m_parsed_record_interval;
+    }
+
+    /** @return The resolved input interval, parsed. */
+    [[nodiscard]] constexpr const Interval& get_parsed_input_interval() const noexcept {
+        return m_parsed_input_interval;
+    }
+
+    /** @return The resolved output interval, parsed. */
+    [[nodiscard]] constexpr const Interval& get_parsed_output_interval() const noexcept {
+        return m_parsed_output_interval;
+    }
+
     /** @return The reference time used by the stream. */
-    [[nodiscard]] constexpr const std::string& get_reference_time() const noexcept {
+    [[nodiscard]] constexpr const string_type& get_reference_time() const noexcept {
         return m_reference_time;
     }
 
     /** @return The record interval used by the stream. */
-    [[nodiscard]] constexpr const std::string& get_record_interval() const noexcept {
+    [[nodiscard]] constexpr const string_type& get_record_interval() const noexcept {
         return m_record_interval;
     }
 
+    /** @return The variables, includes and nested streams the stream names, in MPAS processing order. */
+    [[nodiscard]] constexpr const members_type& get_members() const noexcept {
+        return m_members;
+    }
+
     /** @return Stream direction type: 1=input, 2=output, 3=input+output, 4=none. */
     [[nodiscard]] constexpr int get_type() const noexcept { return m_type; }
 
@@ -136,13 +376,52 @@ public:
     /** @return I/O type (0=pnetcdf, 1=pnetcdf+cdf5, 2=netcdf, 3=netcdf4/hdf5). */
     [[nodiscard]] constexpr int get_iotype() const noexcept { return m_iotype; }
 
+    /** @return The allocator used for the stream's strings. */
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_stream_id.get_allocator(); }
+
+    /** @return True if both streams hold identical parsed values. */
+    [[nodiscard]] bool operator==(const BasicStream&) const = default;
+
 private:
+    /// Parses the interval strings so malformed values fail at load, not at first use.
+    void parse_intervals() {
+        if (auto parsed = try_parse_intervals(); !parsed)
+            throw StreamIntervalError(parsed.error());
+    }
+
+    /// The filename interval goes last: it may be derived from the others,
+    /// and a bad value should be reported against the attribute it came from.
+    std::expected<void, StreamError> try_parse_intervals() {
+        for (auto [parsed, value, attribute] : {
+                 std::tuple{&m_parsed_record_interval, &m_record_interval, "record_interval"},
+                 std::tuple{&m_parsed_input_interval, &m_input_interval, "input_interval"},
+                 std::tuple{&m_parsed_output_interval, &m_output_interval, "output_interval"},
+                 std::tuple{&m_parsed_filename_interval, &m_filename_interval, "filename_interval"}}) {
+            auto interval = try_parse_stream_interval(*value, attribute, m_stream_id);
+            if (!interval)
+                return std::unexpected(std::move(interval.error()));
+            *parsed = *interval;
+        }
+        return {};
+    }
+
     // Core string attributes
-    std::string m_stream_id;
-    std::string m_filename_template;
-    std::string m_filename_interval;
-    std::string m_reference_time;
-    std::string m_record_interval;
+    string_type m_stream_id;
+    template_type m_filename_template;
+    string_type m_filename_interval;
+    string_type m_input_interval;
+    string_type m_output_interval;
+    string_type m_reference_time;
+    string_type m_record_interval;
+
+    // Children naming what the stream reads or writes
+    members_type m_members;
+
+    // Intervals parsed from the strings above
+    Interval m_parsed_filename_interval;
+    Interval m_parsed_record_interval;
+    Interval m_parsed_input_interval;
+    Interval m_parsed_output_interval;
 
     // Parsed integer attributes
     int m_type{0};
@@ -152,6 +431,18 @@ private:
     int m_iotype{0};
 };
 
+/// Stream using the default allocator.
+template<XmlNodeLike Node>
+using Stream = BasicStream<Node>;
+
+namespace pmr {
+
+/// Stream allocating its strings from a `std::pmr::memory_resource`.
+template<XmlNodeLike Node>
+using Stream = BasicStream<Node, std::pmr::polymorphic_allocator<char>>;
+
+} // namespace pmr
+
 } // namespace xml_stream_parser
 
 #endif // XML_STREAM_PARSER_STREAM_HPP
@@ -0,0 +1,151 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_ATTRIBUTES_HPP
+#define XML_STREAM_PARSER_STREAM_ATTRIBUTES_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "keyword_table.hpp"
+#include "parser_concepts.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @brief The stream element attributes understood by the parser.
+ *
+ * The enumerator values index `StreamAttributeTable`.
+ */
+enum class StreamAttribute : std::uint8_t {
+    name,
+    type,
+    filename_template,
+    filename_interval,
+    input_interval,
+    output_interval,
+    reference_time,
+    record_interval,
+    precision,
+    io_type,
+    clobber_mode,
+    count
+};
+
+/// Number of known stream attributes.
+inline constexpr std::size_t STREAM_ATTRIBUTE_COUNT =
+    static_cast<std::size_t>(StreamAttribute::count);
+
+/// Perfect hash for the known stream attribute names: first and last characters.
+struct StreamAttributeHash {
+    [[nodiscard]] constexpr std::size_t operator()(std::string_view s) const noexcept {
+        if (s.empty()) return 0;
+        return static_cast<unsigned char>(s.front()) +
+               3u * static_cast<unsigned char>(s.back());
+    }
+};
+
+/// Attribute names in `StreamAttribute` order, with their generated slot table.
+inline constexpr KeywordTable<STREAM_ATTRIBUTE_COUNT, 32, StreamAttributeHash> STREAM_ATTRIBUTES{
+    {"name", "type", "filename_template", "filename_interval",
+     "input_interval", "output_interval", "reference_time", "record_interval",
+     "precision", "io_type", "clobber_mode"},
+    StreamAttributeHash{}
+};
+
+/**
+ * @brief Classifies an attribute name.
+ * @return The matching `StreamAttribute`, or std::nullopt for unknown attributes.
+ */
+constexpr std::optional<StreamAttribute> classify_stream_attribute(std::string_view key) noexcept {
+    if (const auto i = STREAM_ATTRIBUTES.find(key))
+        return static_cast<StreamAttribute>(*i);
+    return std::nullopt;
+}
+
+/**
+ * @class StreamAttributeTable
+ * @brief Flat, fixed-slot storage for the attributes of one stream element.
+ *
+ * Known attributes live in an array indexed by `StreamAttribute`; anything
+ * else is kept in an overflow vector that stays empty (and unallocated) for
+ * ordinary MPAS stream definitions.
+ *
+ * @tparam String Value storage: `std::string_view` for `XmlNodeView`
+ *                backends, `std::string` for owning `XmlNode` backends.
+ */
+template<typename String>
+class StreamAttributeTable {
+public:
+    using value_type = String;
+
+    /**
+     * @brief Stores an attribute, routing it to its slot or to the overflow list.
+     */
+    template<typename Key, typename Value>
+    void insert(Key&& key, Value&& value) {
+        if (const auto attr = classify_stream_attribute(key)) {
+            const auto i = static_cast<std::size_t>(*attr);
+            m_values[i] = String(std::forward<Value>(value));
+            m_present |= static_cast<std::uint16_t>(1u << i);
+        } else {
+            m_unknown.emplace_back(String(std::forward<Key>(key)), String(std::forward<Value>(value)));
+        }
+    }
+
+    /** @return The attribute's value, or an empty view if it is absent. */
+    [[nodiscard]] std::string_view operator[](StreamAttribute attr) const noexcept {
+        return m_values[static_cast<std::size_t>(attr)];
+    }
+
+    /** @return True if the attribute was present on the element. */
+    [[nodiscard]] bool contains(StreamAttribute attr) const noexcept {
+        return (m_present >> static_cast<std::size_t>(attr)) & 1u;
+    }
+
+    /** @return Attributes that are not one of the known `StreamAttribute`s. */
+    [[nodiscard]] const std::vector<std::pair<String, String>>& unknown() const noexcept {
+        return m_unknown;
+    }
+
+private:
+    static_assert(STREAM_ATTRIBUTE_COUNT <= 16, "presence mask is 16 bits wide");
+
+    std::array<String, STREAM_ATTRIBUTE_COUNT> m_values{};
+    std::uint16_t m_present{0};
+    std::vector<std::pair<String, String>> m_unknown;
+};
+
+/// Attribute storage type matching a node adapter: views for `XmlNodeView`, owned strings otherwise.
+template<XmlNodeLike Node>
+using attribute_string_t = std::conditional_t<XmlNodeView<Node>, std::string_view, std::string>;
+
+/**
+ * @brief Collects the attributes of a stream element in a single pass.
+ *
+ * Each attribute name is classified with the `STREAM_ATTRIBUTES` perfect
+ * hash and stored in its fixed slot. For `XmlNodeView` backends the table
+ * only holds views into the document and does not allocate.
+ */
+template<XmlNodeLike Node>
+[[nodiscard]] StreamAttributeTable<attribute_string_t<Node>>
+parse_stream_attributes(const Node& stream_xml) {
+    StreamAttributeTable<attribute_string_t<Node>> table;
+    if constexpr (XmlNodeView<Node>) {
+        for (const auto& [key, value] : stream_xml.get_attributes())
+            table.insert(std::string_view{key}, std::string_view{value});
+    } else {
+        for (auto&& [key, value] : stream_xml.get_attributes())
+            table.insert(key, std::move(value));
+    }
+    return table;
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_ATTRIBUTES_HPP
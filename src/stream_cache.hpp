@@ -0,0 +1,423 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_CACHE_HPP
+#define XML_STREAM_PARSER_STREAM_CACHE_HPP
+
+#include <array>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hash.hpp"
+#include "mapped_file.hpp"
+#include "pugi_xml_adapter.hpp"
+#include "pugi_xml_view_adapter.hpp"
+#include "stream_set.hpp"
+#include "streams_file.hpp"
+
+namespace xml_stream_parser {
+
+/// Version of the binary cache layout.
+inline constexpr std::uint32_t STREAM_CACHE_FORMAT_VERSION = 3;
+
+/// Version of the parse semantics. Bump whenever the same XML would resolve
+/// to different stream values, so caches written by older parsers are rebuilt.
+inline constexpr std::uint32_t STREAM_PARSER_VERSION = 1;
+
+/**
+ * @brief Cache key for a streams.xml file loaded with the given options.
+ *
+ * Covers the source bytes and every option that changes the resolved
+ * streams. The parser and format versions are checked separately.
+ */
+[[nodiscard]] inline std::uint64_t stream_cache_key(std::span<const std::byte> xml,
+                                                    const LoadOptions& options) noexcept {
+    const std::array<std::uint64_t, 3> resolution{
+        options.intervals.strict ? 1u : 0u,
+        options.intervals.max_depth,
+        static_cast<std::uint64_t>(options.keywords)
+    };
+    return fnv1a_64(std::as_bytes(std::span{resolution}), fnv1a_64(xml));
+}
+
+namespace detail {
+
+inline constexpr std::array<char, 8> STREAM_CACHE_MAGIC{'X', 'S', 'P', 'C', 'A', 'C', 'H', 'E'};
+
+/// Written in native byte order; reads back differently on a foreign-endian host.
+inline constexpr std::uint32_t STREAM_CACHE_BYTE_ORDER = 0x01020304;
+
+/**
+ * Layout: header, then `stream_count` records at `records_offset`, then a
+ * string blob of `strings_size` bytes at `strings_offset`. Records refer to
+ * strings by offset into the blob; the file holds no pointers.
+ */
+struct StreamCacheHeader {
+    std::array<char, 8> magic;
+    std::uint32_t byte_order;
+    std::uint32_t format_version;
+    std::uint32_t parser_version;
+    std::uint32_t reserved;
+    std::uint64_t source_hash;
+    std::uint64_t stream_count;
+    std::uint64_t records_offset;
+    std::uint64_t strings_offset;
+    std::uint64_t strings_size;
+};
+
+struct StreamCacheString {
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+struct StreamCacheRecord {
+    StreamCacheString stream_id;
+    StreamCacheString filename_template;
+    StreamCacheString filename_interval;
+    StreamCacheString input_interval;
+    StreamCacheString output_interval;
+    StreamCacheString reference_time;
+    StreamCacheString record_interval;
+    StreamCacheString members;
+    std::int32_t type;
+    std::int32_t immutable;
+    std::int32_t precision;
+    std::int32_t clobber_mode;
+    std::int32_t iotype;
+};
+
+static_assert(std::is_trivially_copyable_v<StreamCacheHeader>);
+static_assert(std::is_trivially_copyable_v<StreamCacheRecord>);
+
+/// Copies a trivially copyable object out of possibly unaligned mapped bytes.
+template<typename T>
+[[nodiscard]] T read_pod(std::span<const std::byte> bytes, std::size_t offset) noexcept {
+    T value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+} // namespace detail
+
+/**
+ * @class StreamCacheView
+ * @brief Read-only view of a binary stream cache held in memory.
+ *
+ * Opening a view only checks the header, the bounds of every string
+ * reference and the framing of each member list; no text is parsed.
+ * Values handed out by `operator[]` point into the viewed bytes.
+ */
+class StreamCacheView {
+public:
+    /**
+     * @brief Validates `bytes` as a cache for the given source.
+     * @param bytes       The whole cache file, typically a `MappedFile`.
+     * @param source_hash Expected `stream_cache_key` of the source XML.
+     * @return The view, or std::nullopt if the cache is stale, truncated,
+     *         from another parser version, or corrupt.
+     */
+    [[nodiscard]] static std::optional<StreamCacheView>
+    open(std::span<const std::byte> bytes, std::uint64_t source_hash) noexcept {
+        using detail::StreamCacheHeader;
+        using detail::StreamCacheRecord;
+
+        if (bytes.size() < sizeof(StreamCacheHeader))
+            return std::nullopt;
+
+        const auto header = detail::read_pod<StreamCacheHeader>(bytes, 0);
+        if (header.magic != detail::STREAM_CACHE_MAGIC ||
+            header.byte_order != detail::STREAM_CACHE_BYTE_ORDER ||
+            header.format_version != STREAM_CACHE_FORMAT_VERSION ||
+            header.parser_version != STREAM_PARSER_VERSION ||
+            header.source_hash != source_hash)
+            return std::nullopt;
+
+        const auto max_records = bytes.size() / sizeof(StreamCacheRecord);
+        if (header.stream_count > max_records ||
+            header.records_offset > bytes.size() - header.stream_count * sizeof(StreamCacheRecord) ||
+            header.strings_offset > bytes.size() ||
+            header.strings_size > bytes.size() - header.strings_offset)
+            return std::nullopt;
+
+        StreamCacheView view;
+        view.m_bytes   = bytes;
+        view.m_count   = static_cast<std::size_t>(header.stream_count);
+        view.m_records = static_cast<std::size_t>(header.records_offset);
+        view.m_strings = std::string_view{
+            reinterpret_cast<const char*>(bytes.data() + header.strings_offset),
+            static_cast<std::size_t>(header.strings_size)};
+
+        for (std::size_t i = 0; i < view.m_count; ++i) {
+            const auto r = view.record(i);
+            for (const auto& s : {r.stream_id, r.filename_template, r.filename_interval,
+                                  r.input_interval, r.output_interval,
+                                  r.reference_time, r.record_interval, r.members})
+                if (s.offset > view.m_strings.size() || s.size > view.m_strings.size() - s.offset)
+                    return std::nullopt;
+            if (!StreamMembers::is_valid_encoding(view.string(r.members)))
+                return std::nullopt;
+        }
+        return view;
+    }
+
+    /** @return The number of cached streams. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_count; }
+
+    /** @return The values of the i-th cached stream, viewing the cache bytes. */
+    [[nodiscard]] StreamValues operator[](std::size_t i) const noexcept {
+        const auto r = record(i);
+        return {
+            .stream_id         = string(r.stream_id),
+            .filename_template = string(r.filename_template),
+            .filename_interval = string(r.filename_interval),
+            .input_interval    = string(r.input_interval),
+            .output_interval   = string(r.output_interval),
+            .reference_time    = string(r.reference_time),
+            .record_interval   = string(r.record_interval),
+            .members           = string(r.members),
+            .type              = r.type,
+            .immutable         = r.immutable,
+            .precision         = r.precision,
+            .clobber_mode      = r.clobber_mode,
+            .iotype            = r.iotype,
+        };
+    }
+
+private:
+    StreamCacheView() = default;
+
+    [[nodiscard]] detail::StreamCacheRecord record(std::size_t i) const noexcept {
+        return detail::read_pod<detail::StreamCacheRecord>(
+            m_bytes, m_records + i * sizeof(detail::StreamCacheRecord));
+    }
+
+    [[nodiscard]] std::string_view string(detail::StreamCacheString s) const noexcept {
+        return m_strings.substr(s.offset, s.size);
+    }
+
+    std::span<const std::byte> m_bytes;
+    std::size_t m_count{0};
+    std::size_t m_records{0};
+    std::string_view m_strings;
+};
+
+/**
+ * @brief Encodes a loaded stream set in the binary cache layout.
+ * @throws std::runtime_error if the strings exceed the 4 GiB format limit.
+ */
+template<XmlNodeLike Node, typename Allocator>
+[[nodiscard]] std::vector<std::byte> encode_stream_cache(const BasicStreamSet<Node, Allocator>& streams,
+                                                         std::uint64_t source_hash) {
+    using detail::StreamCacheHeader;
+    using detail::StreamCacheRecord;
+    using detail::StreamCacheString;
+
+    // Each distinct string is stored once; streams typically share most of
+    // their intervals, reference times and template fragments.
+    std::string strings;
+    std::unordered_map<std::string_view, StreamCacheString> interned;
+    auto add = [&](std::string_view s) {
+        if (const auto it = interned.find(s); it != interned.end())
+            return it->second;
+        if (strings.size() + s.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::runtime_error("Stream cache string data exceeds 4 GiB");
+        const StreamCacheString ref{static_cast<std::uint32_t>(strings.size()),
+                                    static_cast<std::uint32_t>(s.size())};
+        strings.append(s);
+        interned.emplace(s, ref);
+        return ref;
+    };
+
+    std::vector<StreamCacheRecord> records;
+    records.reserve(streams.size());
+    for (const auto& stream : streams) {
+        const auto v = stream.values();
+        records.push_back({
+            .stream_id         = add(v.stream_id),
+            .filename_template = add(v.filename_template),
+            .filename_interval = add(v.filename_interval),
+            .input_interval    = add(v.input_interval),
+            .output_interval   = add(v.output_interval),
+            .reference_time    = add(v.reference_time),
+            .record_interval   = add(v.record_interval),
+            .members           = add(v.members),
+            .type              = v.type,
+            .immutable         = v.immutable,
+            .precision         = v.precision,
+            .clobber_mode      = v.clobber_mode,
+            .iotype            = v.iotype,
+        });
+    }
+
+    const StreamCacheHeader header{
+        .magic          = detail::STREAM_CACHE_MAGIC,
+        .byte_order     = detail::STREAM_CACHE_BYTE_ORDER,
+        .format_version = STREAM_CACHE_FORMAT_VERSION,
+        .parser_version = STREAM_PARSER_VERSION,
+        .reserved       = 0,
+        .source_hash    = source_hash,
+        .stream_count   = records.size(),
+        .records_offset = sizeof(StreamCacheHeader),
+        .strings_offset = sizeof(StreamCacheHeader) + records.size() * sizeof(StreamCacheRecord),
+        .strings_size   = strings.size(),
+    };
+
+    std::vector<std::byte> bytes(header.strings_offset + strings.size());
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (!records.empty())
+        std::memcpy(bytes.data() + header.records_offset, records.data(),
+                    records.size() * sizeof(StreamCacheRecord));
+    if (!strings.empty())
+        std::memcpy(bytes.data() + header.strings_offset, strings.data(), strings.size());
+    return bytes;
+}
+
+/**
+ * @brief Rebuilds a stream set from validated cache bytes.
+ *
+ * The returned streams own copies of their strings, allocated with `alloc`;
+ * `view` may be released afterwards.
+ *
+ * @throws StreamIntervalError if a cached interval is malformed.
+ */
+template<XmlNodeLike Node, typename Allocator = std::allocator<char>>
+[[nodiscard]] BasicStreamSet<Node, Allocator> restore_stream_set(const StreamCacheView& view,
+                                                                const Allocator& alloc = Allocator{}) {
+    BasicStreamSet<Node, Allocator> set{alloc};
+    typename BasicStreamSet<Node, Allocator>::container_type streams(view.size(), set.get_allocator());
+    for (std::size_t i = 0; i < streams.size(); ++i)
+        streams[i].restore(view[i]);
+
+    set.assign(std::move(streams));
+    return set;
+}
+
+/**
+ * @brief Writes a binary stream cache.
+ *
+ * The cache is written to a temporary file next to `path` and renamed over
+ * it, so concurrent readers (e.g. other MPI ranks) never see a partial file.
+ * The temporary file is created exclusively by `mkstemp`, so writers on
+ * different nodes of a shared filesystem never share one, even when their
+ * process ids collide.
+ *
+ * @throws std::runtime_error if the file cannot be written.
+ */
+template<XmlNodeLike Node, typename Allocator>
+void write_stream_cache(const std::string& path,
+                        const BasicStreamSet<Node, Allocator>& streams,
+                        std::uint64_t source_hash) {
+    const auto bytes = encode_stream_cache(streams, source_hash);
+
+    std::string tmp = path + ".tmp.XXXXXX";
+    const int fd = ::mkstemp(tmp.data());
+    if (fd < 0)
+        throw std::runtime_error(std::format("Failed to create a temporary file for stream cache '{}'", path));
+
+    // mkstemp creates the file 0600; other users' ranks may need to read it.
+    bool written = ::fchmod(fd, 0644) == 0;
+    for (std::size_t done = 0; written && done < bytes.size(); ) {
+        const auto n = ::write(fd, bytes.data() + done, bytes.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        written = n > 0;
+        if (written)
+            done += static_cast<std::size_t>(n);
+    }
+    written = ::close(fd) == 0 && written;
+
+    std::error_code ec;
+    if (!written) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error(std::format("Failed to write stream cache '{}'", tmp));
+    }
+
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error(std::format("Failed to install stream cache '{}'", path));
+    }
+}
+
+/**
+ * @brief Result of `load_or_build`.
+ */
+template<XmlNodeLike Node>
+struct CachedStreamLoad {
+    StreamSet<Node> streams;
+
+    /// True if the streams came from the cache without parsing any XML.
+    bool cache_hit{false};
+};
+
+/**
+ * @brief Loads streams from a binary cache, or parses the XML and refreshes the cache.
+ *
+ * The XML file is mapped once and hashed. If `cache_path` holds a cache with
+ * a matching key and parser version, the streams are restored from it
+ * without parsing. Otherwise the mapped XML is parsed in place, loaded with
+ * `options`, and a fresh cache is written. Failure to write the cache is not
+ * an error; the next call simply rebuilds it.
+ *
+ * @tparam Node `PugiXmlViewAdapter` (default) or `PugiXmlAdapter`.
+ * @throws std::runtime_error / StreamIntervalError if the XML must be parsed and is invalid.
+ */
+template<XmlNodeLike Node = PugiXmlViewAdapter>
+    requires std::same_as<Node, PugiXmlViewAdapter> || std::same_as<Node, PugiXmlAdapter>
+[[nodiscard]] CachedStreamLoad<Node> load_or_build(const std::string& xml_path,
+                                                   const std::string& cache_path,
+                                                   const LoadOptions& options = {}) {
+    auto xml = MappedFile::open(xml_path, MappedFile::Mode::copy_on_write);
+    const auto key = stream_cache_key(xml.bytes(), options);
+
+    CachedStreamLoad<Node> result;
+
+    std::error_code ec;
+    const auto cache = MappedFile::open(cache_path, MappedFile::Mode::read_only, ec);
+    if (!ec) {
+        if (const auto view = StreamCacheView::open(cache.bytes(), key)) {
+            try {
+                result.streams   = restore_stream_set<Node>(*view);
+                result.cache_hit = true;
+                return result;
+            } catch (const StreamIntervalError&) {
+                // Structurally valid but corrupt values; rebuild below.
+            }
+        }
+    }
+
+    const auto file = load_streams_file(std::move(xml), xml_path);
+    if constexpr (std::same_as<Node, PugiXmlViewAdapter>)
+        result.streams.load_from_xml(file.root_view(), options);
+    else
+        result.streams.load_from_xml(file.root(), options);
+
+    try {
+        write_stream_cache(cache_path, result.streams, key);
+    } catch (const std::runtime_error&) {
+        // The cache is an optimization; an unwritable cache location only
+        // means the next load parses the XML again.
+    }
+    return result;
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_CACHE_HPP
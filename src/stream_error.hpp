@@ -0,0 +1,117 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_ERROR_HPP
+#define XML_STREAM_PARSER_STREAM_ERROR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xml_stream_parser {
+
+/**
+ * @brief What went wrong while loading a stream.
+ *
+ * The same conditions are thrown by the throwing load path; the code lets
+ * the non-throwing path report them without comparing messages.
+ */
+enum class StreamErrorCode : std::uint8_t {
+    malformed_interval,          ///< An interval value does not parse.
+    malformed_reference,         ///< A `stream:` reference lacks the `:attr` part.
+    invalid_reference_attribute, ///< A reference names an attribute other than an interval.
+    self_reference,              ///< A reference names its own attribute.
+    missing_stream,              ///< A reference names an undefined stream.
+    missing_attribute,           ///< The referenced stream lacks the attribute.
+    unexpandable_reference,      ///< A strict reference lands on another reference.
+    cyclic_reference,            ///< A reference chain returns to an earlier link.
+    reference_too_deep,          ///< A reference chain exceeds `max_depth` hops.
+    unknown_keyword,             ///< Strict keyword parsing met an unknown keyword.
+    conflicting_keywords,        ///< Strict keyword parsing met incompatible keywords.
+    unnamed_member               ///< A `<var>`, `<file>`, ... child has no name.
+};
+
+/** @return The code's name, e.g. "cyclic_reference". */
+constexpr std::string_view to_string(StreamErrorCode code) noexcept {
+    switch (code) {
+        case StreamErrorCode::malformed_interval:          return "malformed_interval";
+        case StreamErrorCode::malformed_reference:         return "malformed_reference";
+        case StreamErrorCode::invalid_reference_attribute: return "invalid_reference_attribute";
+        case StreamErrorCode::self_reference:              return "self_reference";
+        case StreamErrorCode::missing_stream:              return "missing_stream";
+        case StreamErrorCode::missing_attribute:           return "missing_attribute";
+        case StreamErrorCode::unexpandable_reference:      return "unexpandable_reference";
+        case StreamErrorCode::cyclic_reference:            return "cyclic_reference";
+        case StreamErrorCode::reference_too_deep:          return "reference_too_deep";
+        case StreamErrorCode::unknown_keyword:             return "unknown_keyword";
+        case StreamErrorCode::conflicting_keywords:        return "conflicting_keywords";
+        case StreamErrorCode::unnamed_member:              return "unnamed_member";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief The error half of the `std::expected` results of the `try_` functions.
+ */
+struct StreamError {
+    StreamErrorCode code;
+
+    /// The message the throwing counterpart puts in its exception.
+    std::string message;
+
+    /// The attribute or child element of the failing stream, once known.
+    std::string attribute{};
+};
+
+/**
+ * @brief A stream that could not be loaded, as reported by
+ *        `BasicStreamSet::load_valid_from_xml`.
+ */
+struct StreamDiagnostic {
+    /// The failing stream's name.
+    std::string stream;
+
+    /// The attribute (e.g. "output_interval") or member tag (e.g. "var") at fault.
+    std::string attribute;
+
+    StreamErrorCode code{};
+    std::string message;
+
+    /// Byte offset of the stream element in the document, if the backend reports one.
+    std::optional<std::size_t> offset;
+
+    /// 1-based line of `offset`; filled in by `locate_diagnostics`.
+    std::optional<std::size_t> line;
+
+    [[nodiscard]] bool operator==(const StreamDiagnostic&) const = default;
+};
+
+/**
+ * @brief Fills in `line` for every diagnostic with an offset into `document`.
+ *
+ * The document is scanned once however many diagnostics there are.
+ */
+inline void locate_diagnostics(std::span<StreamDiagnostic> diagnostics, std::string_view document) {
+    std::vector<std::size_t> order(diagnostics.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::sort(order, {}, [&](std::size_t i) { return diagnostics[i].offset.value_or(0); });
+
+    std::size_t pos  = 0;
+    std::size_t line = 1;
+    for (const auto i : order) {
+        auto& diagnostic = diagnostics[i];
+        if (!diagnostic.offset || *diagnostic.offset > document.size())
+            continue;
+        line += static_cast<std::size_t>(std::ranges::count(document.substr(pos, *diagnostic.offset - pos), '\n'));
+        pos = *diagnostic.offset;
+        diagnostic.line = line;
+    }
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_ERROR_HPP
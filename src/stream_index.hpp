@@ -0,0 +1,107 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_INDEX_HPP
+#define XML_STREAM_PARSER_STREAM_INDEX_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "parser_concepts.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @brief Transparent string hash.
+ *
+ * Allows `std::string`-keyed unordered containers to be queried with a
+ * `std::string_view` without materializing a temporary key.
+ */
+struct StringHash {
+    using is_transparent = void;
+
+    [[nodiscard]] std::size_t operator()(std::string_view s) const noexcept {
+        return std::hash<std::string_view>{}(s);
+    }
+};
+
+/**
+ * @class StreamIndex
+ * @brief Name-to-node index over every stream element of a `<streams>` root.
+ *
+ * The index is built by a single walk over the `<immutable_stream>` children
+ * followed by the `<stream>` children of the root, and replaces the linear
+ * `find_stream` scan performed for each `stream:NAME:attr` reference.
+ *
+ * Lookup precedence matches `resolve_target_stream`: immutable streams win
+ * over mutable streams, and within a tag the first element in document
+ * order wins.
+ *
+ * @note The index stores copies of the node adapters. They must not outlive
+ *       the XML document they refer to.
+ *
+ * @tparam Node XML node adapter type satisfying the `XmlNodeLike` concept.
+ */
+template<XmlNodeLike Node>
+class StreamIndex {
+public:
+    StreamIndex() = default;
+
+    /**
+     * @brief Builds the index from the given streams root.
+     * @param streams_root The `<streams>` XML node.
+     */
+    explicit StreamIndex(const Node& streams_root) { build(streams_root); }
+
+    /**
+     * @brief Rebuilds the index from the given streams root.
+     * @param streams_root The `<streams>` XML node.
+     */
+    void build(const Node& streams_root) {
+        m_by_name.clear();
+        m_nodes.clear();
+        add_children(streams_root, "immutable_stream");
+        add_children(streams_root, "stream");
+    }
+
+    /**
+     * @brief Looks up a stream node by name.
+     * @return A pointer to the indexed node, or nullptr if no stream has that name.
+     */
+    [[nodiscard]] const Node* find(std::string_view name) const noexcept {
+        if (const auto it = m_by_name.find(name); it != m_by_name.end())
+            return &m_nodes[it->second];
+        return nullptr;
+    }
+
+    /** @return All indexed stream nodes, immutable streams first, in document order. */
+    [[nodiscard]] const std::vector<Node>& nodes() const noexcept { return m_nodes; }
+
+    /** @return The number of indexed stream nodes. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_nodes.size(); }
+
+    /** @return True if no stream nodes were indexed. */
+    [[nodiscard]] bool empty() const noexcept { return m_nodes.empty(); }
+
+private:
+    void add_children(const Node& root, std::string_view tag) {
+        for (const auto& child : root.children(tag)) {
+            if (!child.has_attribute("name"))
+                continue;
+            m_by_name.try_emplace(std::string(child.get_attribute("name")), m_nodes.size());
+            m_nodes.push_back(child);
+        }
+    }
+
+    /// Stream name to position in `m_nodes`.
+    std::unordered_map<std::string, std::size_t, StringHash, std::equal_to<>> m_by_name;
+
+    /// Every named stream node, in load order.
+    std::vector<Node> m_nodes;
+};
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_INDEX_HPP
@@ -0,0 +1,298 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_KEYWORDS_HPP
+#define XML_STREAM_PARSER_STREAM_KEYWORDS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "keyword_table.hpp"
+#include "stream_error.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @brief How the keyword-valued attributes (`type`, `io_type`, `clobber_mode`,
+ *        `precision`) are interpreted.
+ */
+enum class KeywordParsing : std::uint8_t {
+    /// Substring matching, as `parse_direction` and friends have always done.
+    /// Unknown values fall back to the default code.
+    permissive,
+
+    /// Exact keywords, separated by `,`, `:`, `;` or whitespace. Unknown or
+    /// conflicting keywords throw `StreamKeywordError`.
+    strict
+};
+
+/**
+ * @class StreamKeywordError
+ * @brief Exception type for unknown or conflicting keywords in strict parsing.
+ */
+class StreamKeywordError final : public std::runtime_error {
+public:
+    explicit StreamKeywordError(std::string_view msg)
+        : std::runtime_error(std::string(msg)) {}
+
+    /** @brief Throws the error a `try_` function returned. */
+    explicit StreamKeywordError(const StreamError& error)
+        : StreamKeywordError(error.message) {}
+};
+
+/// The `type` attribute. Values match the codes of `parse_direction`.
+enum class Direction : std::uint8_t {
+    input        = 1,
+    output       = 2,
+    input_output = 3,
+    none         = 4
+};
+
+/// The `io_type` attribute. Values match the codes of `parse_io_type`.
+enum class IoType : std::uint8_t {
+    pnetcdf      = 0,
+    pnetcdf_cdf5 = 1,
+    netcdf       = 2,
+    netcdf4      = 3
+};
+
+/// The `clobber_mode` attribute. Values match the codes of `parse_clobber_mode`.
+enum class ClobberMode : std::uint8_t {
+    never_modify = 0,
+    append       = 1,
+    truncate     = 2,
+    overwrite    = 3
+};
+
+/// The `precision` attribute, in bytes per real. Values match `parse_precision_bytes`.
+enum class Precision : std::uint8_t {
+    native  = 0,
+    single  = 4,
+    double_ = 8
+};
+
+namespace detail {
+
+/// Perfect hash for every keyword table below: first and last characters and length.
+struct StreamKeywordHash {
+    [[nodiscard]] constexpr std::size_t operator()(std::string_view s) const noexcept {
+        if (s.empty()) return 0;
+        return static_cast<unsigned char>(s.front()) +
+               2u * static_cast<unsigned char>(s.back()) + s.size();
+    }
+};
+
+template<std::size_t N>
+using StreamKeywordTable = KeywordTable<N, 8, StreamKeywordHash>;
+
+inline constexpr StreamKeywordTable<3> DIRECTION_KEYWORDS{{"input", "output", "none"}, {}};
+
+/// Bit of each `DIRECTION_KEYWORDS` entry; "none" sets no bit.
+inline constexpr std::array<unsigned, 3> DIRECTION_BITS{1, 2, 0};
+
+inline constexpr StreamKeywordTable<4> IO_TYPE_KEYWORDS{{"pnetcdf", "cdf5", "netcdf", "netcdf4"}, {}};
+
+inline constexpr StreamKeywordTable<5> CLOBBER_MODE_KEYWORDS{
+    {"never_modify", "append", "truncate", "replace_files", "overwrite"}, {}};
+
+inline constexpr std::array<ClobberMode, 5> CLOBBER_MODES{
+    ClobberMode::never_modify, ClobberMode::append, ClobberMode::truncate,
+    ClobberMode::truncate, ClobberMode::overwrite};
+
+inline constexpr StreamKeywordTable<3> PRECISION_KEYWORDS{{"single", "double", "native"}, {}};
+
+inline constexpr std::array<Precision, 3> PRECISIONS{Precision::single, Precision::double_, Precision::native};
+
+constexpr bool is_keyword_separator(char c) noexcept {
+    return c == ',' || c == ':' || c == ';' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/// Calls `f(token)` for each non-empty keyword of `value`, stopping at the first error `f` returns.
+template<typename F>
+constexpr std::expected<void, StreamError> for_each_keyword(std::string_view value, F&& f) {
+    std::size_t pos = 0;
+    while (pos < value.size()) {
+        while (pos < value.size() && is_keyword_separator(value[pos]))
+            ++pos;
+        const auto begin = pos;
+        while (pos < value.size() && !is_keyword_separator(value[pos]))
+            ++pos;
+        if (pos > begin)
+            if (auto visited = f(value.substr(begin, pos - begin)); !visited)
+                return visited;
+    }
+    return {};
+}
+
+/// Position of `token` in `table`.
+template<std::size_t N>
+constexpr std::expected<std::size_t, StreamError> classify_keyword(const StreamKeywordTable<N>& table,
+                                                                   std::string_view token,
+                                                                   std::string_view attribute,
+                                                                   std::string_view stream_id) {
+    if (const auto i = table.find(token))
+        return *i;
+    return std::unexpected(StreamError{StreamErrorCode::unknown_keyword, std::format(
+        "Unknown {} keyword '{}' in stream '{}'", attribute, token, stream_id), std::string(attribute)});
+}
+
+inline StreamError conflicting_keywords(std::string_view attribute,
+                                        std::string_view value,
+                                        std::string_view stream_id) {
+    return {StreamErrorCode::conflicting_keywords, std::format(
+        "Conflicting {} keywords '{}' in stream '{}'", attribute, value, stream_id), std::string(attribute)};
+}
+
+/// Classifies an attribute that takes one keyword; repeating it is allowed.
+template<typename Enum, std::size_t N>
+constexpr std::expected<Enum, StreamError> classify_single_keyword(const StreamKeywordTable<N>& table,
+                                                                   const std::array<Enum, N>& values,
+                                                                   Enum fallback,
+                                                                   std::string_view value,
+                                                                   std::string_view attribute,
+                                                                   std::string_view stream_id) {
+    std::size_t found = N;
+    auto visited = for_each_keyword(value, [&](std::string_view token) -> std::expected<void, StreamError> {
+        const auto i = classify_keyword(table, token, attribute, stream_id);
+        if (!i)
+            return std::unexpected(i.error());
+        if (found != N && values[found] != values[*i])
+            return std::unexpected(conflicting_keywords(attribute, value, stream_id));
+        found = *i;
+        return {};
+    });
+    if (!visited)
+        return std::unexpected(std::move(visited.error()));
+    return found == N ? fallback : values[found];
+}
+
+/// Unwraps a strict classification, throwing `StreamKeywordError` on error.
+template<typename Enum>
+constexpr Enum keyword_or_throw(std::expected<Enum, StreamError> classified) {
+    if (!classified)
+        throw StreamKeywordError(classified.error());
+    return *classified;
+}
+
+} // namespace detail
+
+/**
+ * @brief Non-throwing `classify_direction`.
+ */
+constexpr std::expected<Direction, StreamError> try_classify_direction(std::string_view value,
+                                                                       std::string_view stream_id = {}) {
+    unsigned bits = 0;
+    bool none = false;
+    auto visited = detail::for_each_keyword(value, [&](std::string_view token) -> std::expected<void, StreamError> {
+        const auto i = detail::classify_keyword(detail::DIRECTION_KEYWORDS, token, "type", stream_id);
+        if (!i)
+            return std::unexpected(i.error());
+        bits |= detail::DIRECTION_BITS[*i];
+        none = none || detail::DIRECTION_BITS[*i] == 0;
+        return {};
+    });
+    if (!visited)
+        return std::unexpected(std::move(visited.error()));
+    if (none && bits != 0)
+        return std::unexpected(detail::conflicting_keywords("type", value, stream_id));
+    return bits == 0 ? Direction::none : static_cast<Direction>(bits);
+}
+
+/**
+ * @brief Non-throwing `classify_io_type`.
+ */
+constexpr std::expected<IoType, StreamError> try_classify_io_type(std::string_view value,
+                                                                  std::string_view stream_id = {}) {
+    constexpr unsigned pnetcdf = 1u << 0, cdf5 = 1u << 1, netcdf = 1u << 2, netcdf4 = 1u << 3;
+    unsigned bits = 0;
+    auto visited = detail::for_each_keyword(value, [&](std::string_view token) -> std::expected<void, StreamError> {
+        const auto i = detail::classify_keyword(detail::IO_TYPE_KEYWORDS, token, "io_type", stream_id);
+        if (!i)
+            return std::unexpected(i.error());
+        bits |= 1u << *i;
+        return {};
+    });
+    if (!visited)
+        return std::unexpected(std::move(visited.error()));
+    switch (bits) {
+        case 0:
+        case pnetcdf:        return IoType::pnetcdf;
+        case pnetcdf | cdf5: return IoType::pnetcdf_cdf5;
+        case netcdf:         return IoType::netcdf;
+        case netcdf4:        return IoType::netcdf4;
+        default:             return std::unexpected(detail::conflicting_keywords("io_type", value, stream_id));
+    }
+}
+
+/**
+ * @brief Non-throwing `classify_clobber_mode`.
+ */
+constexpr std::expected<ClobberMode, StreamError> try_classify_clobber_mode(std::string_view value,
+                                                                            std::string_view stream_id = {}) {
+    return detail::classify_single_keyword(detail::CLOBBER_MODE_KEYWORDS, detail::CLOBBER_MODES,
+                                           ClobberMode::never_modify, value, "clobber_mode", stream_id);
+}
+
+/**
+ * @brief Non-throwing `classify_precision`.
+ */
+constexpr std::expected<Precision, StreamError> try_classify_precision(std::string_view value,
+                                                                       std::string_view stream_id = {}) {
+    return detail::classify_single_keyword(detail::PRECISION_KEYWORDS, detail::PRECISIONS,
+                                           Precision::native, value, "precision", stream_id);
+}
+
+/**
+ * @brief Strictly classifies a `type` attribute.
+ *
+ * "input" and "output" may be combined; "none" stands alone. An empty value
+ * is `Direction::none`, as in `parse_direction`.
+ *
+ * @throws StreamKeywordError on an unknown keyword or "none" combined with a direction.
+ */
+constexpr Direction classify_direction(std::string_view value, std::string_view stream_id = {}) {
+    return detail::keyword_or_throw(try_classify_direction(value, stream_id));
+}
+
+/**
+ * @brief Strictly classifies an `io_type` attribute.
+ *
+ * Accepts "pnetcdf", "pnetcdf,cdf5", "netcdf" and "netcdf4". An empty value
+ * is `IoType::pnetcdf`, as in `parse_io_type`.
+ *
+ * @throws StreamKeywordError on an unknown keyword or any other combination.
+ */
+constexpr IoType classify_io_type(std::string_view value, std::string_view stream_id = {}) {
+    return detail::keyword_or_throw(try_classify_io_type(value, stream_id));
+}
+
+/**
+ * @brief Strictly classifies a `clobber_mode` attribute.
+ *
+ * "replace_files" is a synonym of "truncate". An empty value is
+ * `ClobberMode::never_modify`, as in `parse_clobber_mode`.
+ *
+ * @throws StreamKeywordError on an unknown keyword or two different modes.
+ */
+constexpr ClobberMode classify_clobber_mode(std::string_view value, std::string_view stream_id = {}) {
+    return detail::keyword_or_throw(try_classify_clobber_mode(value, stream_id));
+}
+
+/**
+ * @brief Strictly classifies a `precision` attribute.
+ *
+ * An empty value is `Precision::native`, as in `parse_precision_bytes`.
+ *
+ * @throws StreamKeywordError on an unknown keyword or two different precisions.
+ */
+constexpr Precision classify_precision(std::string_view value, std::string_view stream_id = {}) {
+    return detail::keyword_or_throw(try_classify_precision(value, stream_id));
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_KEYWORDS_HPP
@@ -0,0 +1,430 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_MEMBERS_HPP
+#define XML_STREAM_PARSER_STREAM_MEMBERS_HPP
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hash.hpp"
+#include "parser_concepts.hpp"
+#include "stream_error.hpp"
+#include "string_pool.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @brief The child elements of a stream that name what it reads or writes.
+ *
+ * Listed in the order MPAS processes them: `<file>` includes first, then
+ * `<var>`, `<var_array>`, `<var_struct>` and nested `<stream>` references.
+ */
+enum class MemberKind : std::uint8_t { file, var, var_array, var_struct, stream };
+
+/// Every member kind, in processing order.
+inline constexpr std::array<MemberKind, 5> MEMBER_KINDS{
+    MemberKind::file, MemberKind::var, MemberKind::var_array, MemberKind::var_struct, MemberKind::stream
+};
+
+/** @return The element name of a member kind, e.g. `"var_array"`. */
+[[nodiscard]] constexpr std::string_view to_string(MemberKind kind) noexcept {
+    switch (kind) {
+        case MemberKind::file:       return "file";
+        case MemberKind::var:        return "var";
+        case MemberKind::var_array:  return "var_array";
+        case MemberKind::var_struct: return "var_struct";
+        case MemberKind::stream:     return "stream";
+    }
+    return {};
+}
+
+/**
+ * @brief One entry of a stream's member list.
+ *
+ * `name` views the list it was taken from.
+ */
+struct StreamMember {
+    MemberKind kind{MemberKind::var};
+    std::string_view name;
+
+    [[nodiscard]] bool operator==(const StreamMember&) const = default;
+};
+
+namespace detail {
+
+/// Calls `f(kind, child)` for every member child of a stream element, in `MEMBER_KINDS` order.
+template<XmlNodeLike Node, typename F>
+void for_each_member(const Node& stream_xml, F&& f) {
+    for (const auto kind : MEMBER_KINDS)
+        for (const auto& child : stream_xml.children(to_string(kind)))
+            f(kind, child);
+}
+
+/**
+ * Splits the text of a `<file>` include into member names, one per line,
+ * without copying: the names view `text`. Surrounding blanks and `\r` are
+ * trimmed and blank lines skipped.
+ */
+inline std::vector<std::string_view> split_member_lines(std::string_view text) {
+    std::vector<std::string_view> names;
+    for (std::size_t pos = 0; pos < text.size(); ) {
+        auto end = text.find('\n', pos);
+        if (end == std::string_view::npos)
+            end = text.size();
+        const auto line  = text.substr(pos, end - pos);
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first != std::string_view::npos)
+            names.push_back(line.substr(first, line.find_last_not_of(" \t\r") - first + 1));
+        pos = end + 1;
+    }
+    return names;
+}
+
+/// Reads a `<file>` include from disk; see `split_member_lines`.
+inline std::vector<std::string> read_member_file(const std::filesystem::path& path) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in)
+        throw std::runtime_error(std::format("Failed to open member file '{}'", path.string()));
+    const std::string text{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+
+    std::vector<std::string> names;
+    for (const auto name : split_member_lines(text))
+        names.emplace_back(name);
+    return names;
+}
+
+} // namespace detail
+
+/**
+ * @class BasicStreamMembers
+ * @brief The flat list of variables, includes and nested streams a stream names.
+ *
+ * All names live in one string of the stream's string type, encoded as a
+ * kind byte, the name and a NUL per entry. With `InterningAllocator` that
+ * string is interned, so streams listing the same members share it. A
+ * hashed index over the names, built in one pass, makes `contains()` and
+ * `find()` constant time on average; building the list is linear in the
+ * number of members.
+ *
+ * `<file>` entries are recorded but not read while loading, since the
+ * files they name may not be needed; `expand_files()` reads them on request.
+ *
+ * @tparam Allocator Allocator for the list and its index; see `StreamMembers`.
+ */
+template<typename Allocator = std::allocator<char>>
+class BasicStreamMembers {
+    /// One entry of `m_text`; `offset` is that of the name, after the kind byte.
+    struct Entry {
+        std::uint32_t offset;
+        std::uint32_t size;
+        MemberKind kind;
+    };
+
+    using entry_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Entry>;
+    using slot_allocator  = typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint32_t>;
+
+public:
+    using allocator_type = Allocator;
+    using string_type    = stream_string_t<Allocator>;
+
+    /**
+     * @class const_iterator
+     * @brief Forward iterator yielding `StreamMember` values in list order.
+     */
+    class const_iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type       = StreamMember;
+        using difference_type  = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        [[nodiscard]] value_type operator*() const noexcept { return (*m_members)[m_index]; }
+
+        const_iterator& operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        [[nodiscard]] bool operator==(const const_iterator&) const = default;
+
+    private:
+        friend class BasicStreamMembers;
+
+        const_iterator(const BasicStreamMembers* members, std::size_t index) noexcept
+            : m_members{members}, m_index{index} {}
+
+        const BasicStreamMembers* m_members{nullptr};
+        std::size_t m_index{0};
+    };
+
+    BasicStreamMembers() = default;
+
+    explicit BasicStreamMembers(const Allocator& alloc) noexcept
+        : m_text{alloc}, m_entries{entry_allocator{alloc}}, m_slots{slot_allocator{alloc}} {}
+
+    BasicStreamMembers(const BasicStreamMembers&) = default;
+    BasicStreamMembers(BasicStreamMembers&&) noexcept = default;
+    BasicStreamMembers& operator=(const BasicStreamMembers&) = default;
+    BasicStreamMembers& operator=(BasicStreamMembers&&) = default;
+
+    BasicStreamMembers(const BasicStreamMembers& other, const Allocator& alloc)
+        : m_text{other.m_text, alloc},
+          m_entries{other.m_entries, entry_allocator{alloc}},
+          m_slots{other.m_slots, slot_allocator{alloc}} {}
+
+    BasicStreamMembers(BasicStreamMembers&& other, const Allocator& alloc)
+        : m_text{std::move(other.m_text), alloc},
+          m_entries{std::move(other.m_entries), entry_allocator{alloc}},
+          m_slots{std::move(other.m_slots), slot_allocator{alloc}} {}
+
+    /**
+     * @brief Collects the member children of a stream element.
+     * @param stream_xml The `<stream>` or `<immutable_stream>` element.
+     * @param stream_id  The stream's name, for error messages.
+     * @throws std::runtime_error if a member element has no `name` attribute.
+     */
+    template<XmlNodeLike Node>
+    void load_from_xml(const Node& stream_xml, std::string_view stream_id) {
+        if (auto loaded = try_load_from_xml(stream_xml, stream_id); !loaded)
+            throw std::runtime_error(loaded.error().message);
+    }
+
+    /**
+     * @brief Non-throwing `load_from_xml`; the list is unchanged on error.
+     * @return The first member element without a name, as an error.
+     */
+    template<XmlNodeLike Node>
+    std::expected<void, StreamError> try_load_from_xml(const Node& stream_xml, std::string_view stream_id) {
+        std::string encoded;
+        std::optional<StreamError> error;
+        detail::for_each_member(stream_xml, [&](MemberKind kind, const Node& child) {
+            if (error)
+                return;
+            const auto raw = child.get_attribute("name");
+            const std::string_view name{raw};
+            if (name.empty()) {
+                error = StreamError{StreamErrorCode::unnamed_member, std::format(
+                    "Stream '{}' has a <{}> element without a name", stream_id, to_string(kind)), std::string(to_string(kind))};
+                return;
+            }
+            encoded += encode(kind);
+            encoded += name;
+            encoded += '\0';
+        });
+        if (error)
+            return std::unexpected(std::move(*error));
+        assign(encoded, stream_id);
+        return {};
+    }
+
+    /**
+     * @brief Restores a list from the form returned by `encoded()`.
+     * @throws std::runtime_error if `encoded` is not a valid member list.
+     */
+    void restore(std::string_view encoded, std::string_view stream_id) {
+        assign(encoded, stream_id);
+    }
+
+    /**
+     * @brief Checks that `encoded` has the form produced by `encoded()`.
+     *
+     * Lets callers holding untrusted bytes, such as a cache file, reject
+     * them up front instead of catching `restore`'s exception.
+     */
+    [[nodiscard]] static bool is_valid_encoding(std::string_view encoded) noexcept {
+        for (std::size_t pos = 0; pos < encoded.size(); ) {
+            const auto end = encoded.find('\0', pos);
+            const auto kind = static_cast<unsigned char>(encoded[pos] - '0');
+            if (end == std::string_view::npos || end == pos + 1 || kind >= MEMBER_KINDS.size())
+                return false;
+            pos = end + 1;
+        }
+        return true;
+    }
+
+    /** @return The list in its flat encoded form, for caches and serialization. */
+    [[nodiscard]] const string_type& encoded() const noexcept { return m_text; }
+
+    /** @return The number of members, duplicates included. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+
+    /** @return True if the stream names no members. */
+    [[nodiscard]] bool empty() const noexcept { return m_entries.empty(); }
+
+    /** @return The i-th member in list order. */
+    [[nodiscard]] StreamMember operator[](std::size_t i) const noexcept {
+        const auto& entry = m_entries[i];
+        return {entry.kind, std::string_view{m_text}.substr(entry.offset, entry.size)};
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return {this, 0}; }
+    [[nodiscard]] const_iterator end() const noexcept { return {this, size()}; }
+
+    /** @return The first member with the given name, of any kind, or std::nullopt. */
+    [[nodiscard]] std::optional<StreamMember> find(std::string_view name) const noexcept {
+        if (m_slots.empty())
+            return std::nullopt;
+        const auto mask = m_slots.size() - 1;
+        for (auto slot = fnv1a_64(name) & mask; m_slots[slot] != 0; slot = (slot + 1) & mask) {
+            const auto member = (*this)[m_slots[slot] - 1];
+            if (member.name == name)
+                return member;
+        }
+        return std::nullopt;
+    }
+
+    /** @return True if any member has the given name. */
+    [[nodiscard]] bool contains(std::string_view name) const noexcept {
+        return find(name).has_value();
+    }
+
+    /** @return True if the list has `<file>` entries still to be expanded. */
+    [[nodiscard]] bool has_files() const noexcept {
+        for (const auto& entry : m_entries)
+            if (entry.kind == MemberKind::file)
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief Replaces every `<file>` entry with the `var` members it lists.
+     *
+     * Each distinct file is read once, however many entries name it.
+     *
+     * @param read_file Callable taking a file name and returning a range of
+     *                  member names convertible to `std::string_view`, such
+     *                  as a `MemberFiles` loaded for the whole stream set.
+     * @return The expanded list, using this list's allocator.
+     */
+    template<std::invocable<std::string_view> ReadFile>
+    [[nodiscard]] BasicStreamMembers expand_files(ReadFile&& read_file) const {
+        std::unordered_map<std::string_view, std::string> included;
+        std::string encoded;
+        for (const auto member : *this) {
+            if (member.kind != MemberKind::file) {
+                append(encoded, member);
+                continue;
+            }
+            auto [it, inserted] = included.try_emplace(member.name);
+            if (inserted)
+                for (const auto& name : read_file(member.name))
+                    append(it->second, {MemberKind::var, std::string_view{name}});
+            encoded += it->second;
+        }
+
+        BasicStreamMembers expanded{get_allocator()};
+        expanded.assign(encoded, {});
+        return expanded;
+    }
+
+    /**
+     * @brief Expands `<file>` entries by reading them relative to `directory`.
+     *
+     * Each file lists one member name per line; blank lines are skipped. To
+     * expand every stream of a set, `load_member_files` reads each file once
+     * and concurrently.
+     *
+     * @throws std::runtime_error if a file cannot be opened.
+     */
+    [[nodiscard]] BasicStreamMembers expand_files(const std::filesystem::path& directory = {}) const {
+        return expand_files([&](std::string_view file) {
+            return detail::read_member_file(directory / file);
+        });
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_text.get_allocator(); }
+
+    /** @return True if both lists hold the same members in the same order. */
+    [[nodiscard]] bool operator==(const BasicStreamMembers& other) const noexcept {
+        return m_text == other.m_text;
+    }
+
+private:
+    [[nodiscard]] static constexpr char encode(MemberKind kind) noexcept {
+        return static_cast<char>('0' + static_cast<int>(kind));
+    }
+
+    static void append(std::string& encoded, StreamMember member) {
+        encoded += encode(member.kind);
+        encoded += member.name;
+        encoded += '\0';
+    }
+
+    /// Stores `encoded` and rebuilds the entries and the index from it.
+    void assign(std::string_view encoded, std::string_view stream_id) {
+        if (encoded.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::runtime_error(std::format("Member list of stream '{}' exceeds 4 GiB", stream_id));
+        if (!is_valid_encoding(encoded))
+            throw std::runtime_error(std::format("Malformed member list for stream '{}'", stream_id));
+
+        std::vector<Entry, entry_allocator> entries{entry_allocator{get_allocator()}};
+        for (std::size_t pos = 0; pos < encoded.size(); ) {
+            const auto end = encoded.find('\0', pos);
+            entries.push_back({static_cast<std::uint32_t>(pos + 1),
+                               static_cast<std::uint32_t>(end - pos - 1),
+                               static_cast<MemberKind>(encoded[pos] - '0')});
+            pos = end + 1;
+        }
+
+        m_text    = encoded;
+        m_entries = std::move(entries);
+        build_index();
+    }
+
+    /// Open-addressed table at most half full; slots hold entry index + 1, 0 when free.
+    void build_index() {
+        m_slots.assign(m_entries.empty() ? 0 : std::bit_ceil(m_entries.size() * 2), 0);
+        const auto mask = m_slots.size() - 1;
+        for (std::size_t i = 0; i < m_entries.size(); ++i) {
+            const auto name = (*this)[i].name;
+            auto slot = fnv1a_64(name) & mask;
+            for (; m_slots[slot] != 0; slot = (slot + 1) & mask)
+                if ((*this)[m_slots[slot] - 1].name == name)
+                    break;
+            if (m_slots[slot] == 0)
+                m_slots[slot] = static_cast<std::uint32_t>(i + 1);
+        }
+    }
+
+    string_type m_text;
+    std::vector<Entry, entry_allocator> m_entries;
+    std::vector<std::uint32_t, slot_allocator> m_slots;
+};
+
+/// Member list using the default allocator.
+using StreamMembers = BasicStreamMembers<>;
+
+namespace pmr {
+
+/// Member list allocating from a `std::pmr::memory_resource`.
+using StreamMembers = BasicStreamMembers<std::pmr::polymorphic_allocator<char>>;
+
+} // namespace pmr
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_MEMBERS_HPP
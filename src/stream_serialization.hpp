@@ -0,0 +1,61 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_SERIALIZATION_HPP
+#define XML_STREAM_PARSER_STREAM_SERIALIZATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "pugi_xml_view_adapter.hpp"
+#include "stream_cache.hpp"
+#include "stream_set.hpp"
+
+namespace xml_stream_parser {
+
+/// Key stamped into buffers produced by `serialize`; they describe no particular source file.
+inline constexpr std::uint64_t SERIALIZED_STREAMS_KEY = 0;
+
+/**
+ * @brief Serializes a resolved stream set into one relocatable buffer.
+ *
+ * Intended for parse-once, broadcast-many setups: one process loads
+ * streams.xml and ships the buffer to the others over any byte transport
+ * (MPI_Bcast, shared memory, a pipe). The buffer uses the stream cache
+ * layout: fixed-size records of packed integers and offsets into a single
+ * blob of interned strings. It holds no pointers and no padding.
+ *
+ * Sender and receivers must share byte order and parser version; a
+ * mismatch is detected by `deserialize`.
+ *
+ * @throws std::runtime_error if the strings exceed the 4 GiB format limit.
+ */
+template<XmlNodeLike Node, typename Allocator>
+[[nodiscard]] std::vector<std::byte> serialize(const BasicStreamSet<Node, Allocator>& streams) {
+    return encode_stream_cache(streams, SERIALIZED_STREAMS_KEY);
+}
+
+/**
+ * @brief Rebuilds a stream set from a buffer produced by `serialize`.
+ *
+ * The buffer may be released once this returns.
+ *
+ * @tparam Node      Node type of the resulting set; need not match the sender's.
+ * @tparam Allocator Allocator of the resulting set, e.g. a `std::pmr` arena.
+ * @throws std::runtime_error if the buffer is truncated, corrupt, or was
+ *         produced by a different parser version or byte order.
+ */
+template<XmlNodeLike Node = PugiXmlViewAdapter, typename Allocator = std::allocator<char>>
+[[nodiscard]] BasicStreamSet<Node, Allocator> deserialize(std::span<const std::byte> bytes,
+                                                         const Allocator& alloc = Allocator{}) {
+    const auto view = StreamCacheView::open(bytes, SERIALIZED_STREAMS_KEY);
+    if (!view)
+        throw std::runtime_error("Invalid serialized stream buffer");
+    return restore_stream_set<Node>(*view, alloc);
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_SERIALIZATION_HPP
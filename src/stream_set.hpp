@@ -0,0 +1,643 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_SET_HPP
+#define XML_STREAM_PARSER_STREAM_SET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "hash.hpp"
+#include "instrumentation.hpp"
+#include "interval_resolver.hpp"
+#include "stream.hpp"
+#include "stream_index.hpp"
+#include "string_pool.hpp"
+#include "worker_pool.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @brief Options controlling how `StreamSet::load_from_xml` distributes work.
+ */
+struct LoadOptions {
+    /// Load streams concurrently on a pool of worker threads.
+    bool parallel{false};
+
+    /// Upper bound on worker threads; 0 uses `std::thread::hardware_concurrency()`.
+    unsigned max_threads{0};
+
+    /// Streams below which spawning another worker is not worth its cost.
+    std::size_t min_streams_per_thread{256};
+
+    /// How `stream:` interval references are followed.
+    IntervalResolverOptions intervals{};
+
+    /// How keyword-valued attributes are read; strict rejects unknown keywords.
+    KeywordParsing keywords{KeywordParsing::permissive};
+
+    /// Accumulates the load's statistics. Phase costs are only measured when
+    /// built with `XML_STREAM_PARSER_INSTRUMENTATION`.
+    LoadStats* stats{nullptr};
+};
+
+/**
+ * @brief The streams that differ between two loads, as reported by `reload`.
+ *
+ * Streams are identified by name. A name defined more than once (for
+ * example as both an immutable and a mutable stream) is matched by its
+ * position among the elements sharing that name.
+ */
+struct StreamChangeSet {
+    /// Streams present only in the new document.
+    std::vector<std::string> added;
+
+    /// Streams present only in the old document.
+    std::vector<std::string> removed;
+
+    /// Streams present in both whose resolved values differ.
+    std::vector<std::string> modified;
+
+    /** @return True if the reload changed nothing. */
+    [[nodiscard]] bool empty() const noexcept {
+        return added.empty() && removed.empty() && modified.empty();
+    }
+};
+
+/**
+ * @class BasicStreamSet
+ * @brief Owns every `Stream` defined by a `<streams>` document.
+ *
+ * `load_from_xml()` walks the `<streams>` root once to build a
+ * `StreamIndex`, then loads each stream through an `IntervalResolver` over
+ * that index, so every `stream:NAME:attr` reference is a hashed lookup and
+ * every referenced attribute is resolved once. Total load cost is linear in
+ * the number of streams.
+ *
+ * Once the index exists each stream load only reads shared data (the
+ * resolver memo is internally synchronized), so `LoadOptions::parallel`
+ * splits the streams into contiguous chunks and loads them on worker
+ * threads. The result is identical to a serial load.
+ *
+ * Streams are stored immutable streams first, each group in document order,
+ * matching the order in which MPAS processes them.
+ *
+ * Each load also records a fingerprint of every stream element, so that
+ * `reload()` can apply an edited document by re-resolving only the streams
+ * it affects.
+ *
+ * The streams, their strings and the name lookup table are allocated with
+ * `Allocator`. `pmr::StreamSet` over a `std::pmr::monotonic_buffer_resource`
+ * keeps a whole document in one arena; the index and resolver used while
+ * loading are temporaries on the default heap.
+ *
+ * @tparam Node      XML node adapter type satisfying the `XmlNodeLike` concept.
+ * @tparam Allocator Allocator for the stored streams (see `StreamSet`, `pmr::StreamSet`).
+ */
+template<XmlNodeLike Node, typename Allocator = std::allocator<char>>
+class BasicStreamSet {
+    template<typename T>
+    using rebind = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+public:
+    using allocator_type = Allocator;
+    using stream_type    = BasicStream<Node, Allocator>;
+    using container_type = std::vector<stream_type, rebind<stream_type>>;
+    using const_iterator = typename container_type::const_iterator;
+
+    BasicStreamSet() = default;
+
+    /** @param alloc Allocator for the streams and lookup table. */
+    explicit BasicStreamSet(const Allocator& alloc) noexcept
+        : m_streams{alloc}, m_by_name{alloc} {}
+
+    /**
+     * @brief Loads every stream defined under the given root.
+     *
+     * Previously loaded streams are replaced only if the whole load succeeds.
+     * In parallel mode the exception reported is the one a serial load would
+     * have thrown: the error of the first failing stream in load order.
+     *
+     * @param streams_root The `<streams>` XML node.
+     * @param options      Serial or parallel loading.
+     * @throws StreamIntervalError on the first invalid interval reference.
+     * @throws StreamKeywordError on the first unknown keyword, in strict mode.
+     */
+    void load_from_xml(const Node& streams_root, const LoadOptions& options = {}) {
+        LoadStats stats;
+        const StatsScope scope{options.stats ? &stats : nullptr};
+
+        const auto index = [&] {
+            const PhaseTimer timer{LoadPhase::index};
+            return StreamIndex<Node>{streams_root};
+        }();
+        const IntervalResolver<Node> resolver{index, options.intervals};
+        const auto& nodes = index.nodes();
+
+        container_type streams(nodes.size(), m_streams.get_allocator());
+        std::vector<std::uint64_t> fingerprints(nodes.size());
+        const auto workers = worker_count(options, nodes.size());
+        if (workers <= 1)
+            load_range(streams, fingerprints, nodes, resolver, options.keywords, 0, nodes.size());
+        else
+            stats += load_parallel(streams, fingerprints, nodes, resolver, options.keywords, workers,
+                                   options.stats != nullptr);
+
+        assign(std::move(streams));
+        m_fingerprints = std::move(fingerprints);
+        m_intervals    = options.intervals;
+        m_keywords     = options.keywords;
+
+        if (options.stats) {
+            stats.streams = nodes.size();
+            *options.stats += stats;
+        }
+    }
+
+    /**
+     * @brief Loads every valid stream under the given root and reports the rest.
+     *
+     * Each stream goes through `BasicStream::try_load_from_xml`, so an
+     * invalid stream costs no exception and does not stop the load: one pass
+     * yields a diagnostic for every invalid stream. The set is replaced by
+     * the valid streams, in load order. A stream referring to an invalid one
+     * still resolves against its element, and fails only if that reference
+     * itself cannot be followed.
+     *
+     * @param streams_root The `<streams>` XML node.
+     * @param options      Interval and keyword rules and statistics; the load is serial.
+     * @return One diagnostic per invalid stream, in load order. Offsets are set
+     *         when `Node` reports them; pass the document text to
+     *         `locate_diagnostics` for line numbers.
+     */
+    [[nodiscard]] std::vector<StreamDiagnostic> load_valid_from_xml(const Node& streams_root,
+                                                                    const LoadOptions& options = {}) {
+        LoadStats stats;
+        const StatsScope scope{options.stats ? &stats : nullptr};
+
+        const auto index = [&] {
+            const PhaseTimer timer{LoadPhase::index};
+            return StreamIndex<Node>{streams_root};
+        }();
+        const IntervalResolver<Node> resolver{index, options.intervals};
+        const auto& nodes = index.nodes();
+
+        container_type streams(nodes.size(), m_streams.get_allocator());
+        std::vector<std::uint64_t> fingerprints;
+        fingerprints.reserve(nodes.size());
+        std::vector<StreamDiagnostic> diagnostics;
+        for (const auto& node : nodes) {
+            auto& stream = streams[fingerprints.size()];
+            if (auto loaded = stream.try_load_from_xml(node, resolver, options.keywords); !loaded) {
+                auto& error = loaded.error();
+                diagnostics.push_back({
+                    .stream    = std::string(node.get_attribute("name")),
+                    .attribute = std::move(error.attribute),
+                    .code      = error.code,
+                    .message   = std::move(error.message),
+                    .offset    = source_offset(node),
+                    .line      = std::nullopt,
+                });
+                continue;
+            }
+            fingerprints.push_back(fingerprint(node));
+        }
+        streams.erase(streams.begin() + static_cast<std::ptrdiff_t>(fingerprints.size()), streams.end());
+
+        assign(std::move(streams));
+        m_fingerprints = std::move(fingerprints);
+        m_intervals    = options.intervals;
+        m_keywords     = options.keywords;
+
+        if (options.stats) {
+            stats.streams = nodes.size();
+            *options.stats += stats;
+        }
+        return diagnostics;
+    }
+
+    /**
+     * @brief Applies an edited document, re-resolving only what changed.
+     *
+     * Each stream element is fingerprinted by its tag, attributes and member
+     * children (`<var>`, `<file>`, ...). A stream is reloaded if its own
+     * element changed, or if a `stream:NAME:attr` reference it follows
+     * (directly or through a chain) now lands on a stream element that
+     * changed, appeared or disappeared. Every other
+     * stream is kept as loaded. The resulting set is identical to a full
+     * `load_from_xml()` of the new document with the same options.
+     *
+     * If the set was not loaded from XML (e.g. it was restored from a cache),
+     * or was loaded with different `options.intervals` or `options.keywords`,
+     * there are no fingerprints to compare against, and every stream is
+     * reloaded.
+     *
+     * Like `load_from_xml()`, the set is unchanged if the reload throws.
+     *
+     * @param streams_root The `<streams>` XML node of the new document.
+     * @param options      Interval resolution and statistics; reloads are serial.
+     * @return The streams added, removed and modified by the reload.
+     * @throws StreamIntervalError on the first invalid interval reference.
+     * @throws StreamKeywordError on the first unknown keyword, in strict mode.
+     */
+    StreamChangeSet reload(const Node& streams_root, const LoadOptions& options = {}) {
+        return reload(streams_root, options, get_allocator());
+    }
+
+    /**
+     * @brief `reload()` building the new streams with `alloc`.
+     *
+     * Kept streams are moved into storage from `alloc`, which copies their
+     * strings if it differs from the set's allocator. An allocator that
+     * propagates on move assignment, such as `InterningAllocator`, then
+     * replaces the set's own.
+     */
+    StreamChangeSet reload(const Node& streams_root, const LoadOptions& options, const Allocator& alloc) {
+        LoadStats stats;
+        const StatsScope scope{options.stats ? &stats : nullptr};
+
+        const auto index = [&] {
+            const PhaseTimer timer{LoadPhase::index};
+            return StreamIndex<Node>{streams_root};
+        }();
+        const IntervalResolver<Node> resolver{index, options.intervals};
+        const auto& nodes = index.nodes();
+
+        const bool fingerprinted = m_fingerprints.size() == m_streams.size()
+                                && m_intervals == options.intervals && m_keywords == options.keywords;
+        std::vector<std::uint64_t> fingerprints(nodes.size());
+        std::vector<std::string> names(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            fingerprints[i] = fingerprint(nodes[i]);
+            names[i]        = std::string(nodes[i].get_attribute("name"));
+        }
+
+        // Pair each new element with the old stream of the same name and occurrence.
+        std::unordered_map<std::string, std::vector<std::size_t>, StringHash, std::equal_to<>> old_by_name;
+        for (std::size_t i = 0; i < m_streams.size(); ++i)
+            old_by_name[std::string(m_streams[i].get_stream_id())].push_back(i);
+
+        std::unordered_map<std::string_view, std::size_t> occurrences;
+        std::vector<std::optional<std::size_t>> previous(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            const auto nth = occurrences[names[i]]++;
+            if (const auto it = old_by_name.find(names[i]);
+                it != old_by_name.end() && nth < it->second.size())
+                previous[i] = it->second[nth];
+        }
+
+        // Names whose winning element (the one references land on) changed.
+        std::unordered_set<std::string_view> dirty;
+        if (fingerprinted) {
+            for (const auto& entry : old_by_name)
+                if (!index.find(entry.first))
+                    dirty.insert(entry.first);
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                if (index.find(names[i]) != &nodes[i])
+                    continue;
+                const auto it = old_by_name.find(names[i]);
+                if (it == old_by_name.end() || m_fingerprints[it->second.front()] != fingerprints[i])
+                    dirty.insert(names[i]);
+            }
+        }
+
+        // Propagate along reverse reference edges: a stream whose winning
+        // element follows a dirty name resolves differently, and so does
+        // anything following it in turn.
+        const auto references = collect_references(nodes);
+        std::unordered_map<std::string_view, std::vector<std::string_view>> dependents;
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+            for (const auto& target : references[i])
+                dependents[target].push_back(names[i]);
+
+        std::vector<std::string_view> pending(dirty.begin(), dirty.end());
+        while (!pending.empty()) {
+            const auto name = pending.back();
+            pending.pop_back();
+            if (const auto it = dependents.find(name); it != dependents.end())
+                for (const auto dependent : it->second)
+                    if (dirty.insert(dependent).second)
+                        pending.push_back(dependent);
+        }
+
+        auto unchanged = [&](std::size_t i) {
+            return fingerprinted && previous[i] && m_fingerprints[*previous[i]] == fingerprints[i]
+                && std::ranges::none_of(references[i], [&](const auto& target) { return dirty.contains(target); });
+        };
+
+        container_type streams(nodes.size(), rebind<stream_type>{alloc});
+        std::size_t reloaded = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (unchanged(i))
+                continue;
+            streams[i].load_from_xml(nodes[i], resolver, options.keywords);
+            ++reloaded;
+        }
+
+        // Nothing below throws except on allocation; the old streams are
+        // only moved from once every reload has succeeded.
+        StreamChangeSet changes;
+        std::vector<bool> matched(m_streams.size(), false);
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (!previous[i]) {
+                changes.added.push_back(names[i]);
+                continue;
+            }
+            matched[*previous[i]] = true;
+            if (!unchanged(i) && !(streams[i] == m_streams[*previous[i]]))
+                changes.modified.push_back(names[i]);
+        }
+        for (std::size_t i = 0; i < m_streams.size(); ++i)
+            if (!matched[i])
+                changes.removed.push_back(std::string(m_streams[i].get_stream_id()));
+
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+            if (unchanged(i))
+                streams[i] = std::move(m_streams[*previous[i]]);
+
+        assign(std::move(streams));
+        m_fingerprints = std::move(fingerprints);
+        m_intervals    = options.intervals;
+        m_keywords     = options.keywords;
+
+        if (options.stats) {
+            stats.streams = reloaded;
+            *options.stats += stats;
+        }
+        return changes;
+    }
+
+    /**
+     * @brief Replaces the set's contents with streams loaded elsewhere.
+     *
+     * Used when streams are restored from a cache rather than parsed. The
+     * next `reload()` reloads every stream.
+     */
+    void assign(container_type streams) {
+        name_map by_name{streams.get_allocator()};
+        by_name.reserve(streams.size());
+        for (std::size_t i = 0; i < streams.size(); ++i)
+            by_name.try_emplace(streams[i].get_stream_id(), i);
+
+        m_streams = std::move(streams);
+        m_by_name = std::move(by_name);
+        m_fingerprints.clear();
+    }
+
+    /**
+     * @brief Looks up a loaded stream by name.
+     * @return A pointer to the stream, or nullptr if no stream has that name.
+     */
+    [[nodiscard]] const stream_type* find(std::string_view name) const noexcept {
+        if (const auto it = m_by_name.find(name); it != m_by_name.end())
+            return &m_streams[it->second];
+        return nullptr;
+    }
+
+    /** @return True if a stream with the given name was loaded. */
+    [[nodiscard]] bool contains(std::string_view name) const noexcept {
+        return find(name) != nullptr;
+    }
+
+    /** @return All loaded streams. */
+    [[nodiscard]] const container_type& streams() const noexcept { return m_streams; }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return m_streams.begin(); }
+    [[nodiscard]] const_iterator end() const noexcept { return m_streams.end(); }
+
+    /** @return The number of loaded streams. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_streams.size(); }
+
+    /** @return True if no streams are loaded. */
+    [[nodiscard]] bool empty() const noexcept { return m_streams.empty(); }
+
+    /** @return The allocator used for the stored streams. */
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_streams.get_allocator(); }
+
+private:
+    using name_map = std::unordered_map<typename stream_type::string_type, std::size_t,
+                                        StringHash, std::equal_to<>,
+                                        rebind<std::pair<const typename stream_type::string_type, std::size_t>>>;
+
+    static std::size_t worker_count(const LoadOptions& options, std::size_t count) noexcept {
+        if (!options.parallel || count == 0)
+            return 1;
+        std::size_t threads = options.max_threads != 0
+                                  ? options.max_threads
+                                  : std::max(1u, std::thread::hardware_concurrency());
+        const auto per_thread = std::max<std::size_t>(1, options.min_streams_per_thread);
+        return std::clamp<std::size_t>(count / per_thread, 1, threads);
+    }
+
+    /**
+     * Hash of a stream element's tag, attributes and member children.
+     * Attributes are combined order-independently, since reordering them
+     * changes nothing; members are hashed in list order, which is kept.
+     */
+    static std::uint64_t fingerprint(const Node& node) {
+        std::uint64_t hash = fnv1a_64(std::string_view{node.name()});
+        for (const auto& [key, value] : node.get_attributes())
+            hash += mix_64(fnv1a_64(std::string_view{value}, fnv1a_64("=", fnv1a_64(std::string_view{key}))));
+
+        constexpr std::string_view separator{"\0", 1};
+        std::uint64_t members = FNV1A_64_OFFSET_BASIS;
+        detail::for_each_member(node, [&](MemberKind kind, const Node& child) {
+            const auto name = child.get_attribute("name");
+            members = fnv1a_64(separator, fnv1a_64(to_string(kind), members));
+            members = fnv1a_64(separator, fnv1a_64(std::string_view{name}, members));
+        });
+        return hash + mix_64(members);
+    }
+
+    /// Names of the streams each element's interval attributes reference directly.
+    static std::vector<std::vector<std::string>> collect_references(const std::vector<Node>& nodes) {
+        std::vector<std::vector<std::string>> references(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            for (const std::string_view attr : {"input_interval", "output_interval"}) {
+                if (!nodes[i].has_attribute(attr))
+                    continue;
+                const auto raw = nodes[i].get_attribute(attr);
+                const std::string_view value{raw};
+                if (!value.starts_with("stream:"))
+                    continue;
+                const auto target = value.substr(7); // remove "stream:"
+                references[i].emplace_back(target.substr(0, target.find(':')));
+            }
+        }
+        return references;
+    }
+
+    static void load_range(container_type& streams,
+                           std::vector<std::uint64_t>& fingerprints,
+                           const std::vector<Node>& nodes,
+                           const IntervalResolver<Node>& resolver,
+                           KeywordParsing keywords,
+                           std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            streams[i].load_from_xml(nodes[i], resolver, keywords);
+            fingerprints[i] = fingerprint(nodes[i]);
+        }
+    }
+
+    /**
+     * Each worker loads one contiguous chunk in order and stops at its first
+     * failure. Chunks are ordered, so the first chunk with an error holds the
+     * error of the first failing stream overall.
+     *
+     * @return The workers' summed statistics, if `collect_stats` is set.
+     */
+    static LoadStats load_parallel(container_type& streams,
+                                   std::vector<std::uint64_t>& fingerprints,
+                                   const std::vector<Node>& nodes,
+                                   const IntervalResolver<Node>& resolver,
+                                   KeywordParsing keywords,
+                                   std::size_t workers,
+                                   bool collect_stats) {
+        std::vector<LoadStats> worker_stats(collect_stats ? workers : 0);
+        const auto chunk = (nodes.size() + workers - 1) / workers;
+
+        detail::run_workers(workers, [&](std::size_t w) {
+            const auto first = std::min(w * chunk, nodes.size());
+            const auto last  = std::min(first + chunk, nodes.size());
+            const StatsScope scope{collect_stats ? &worker_stats[w] : nullptr};
+            load_range(streams, fingerprints, nodes, resolver, keywords, first, last);
+        });
+
+        LoadStats total;
+        for (const auto& stats : worker_stats)
+            total += stats;
+        return total;
+    }
+
+    container_type m_streams;
+
+    /// Stream name to position in `m_streams`.
+    name_map m_by_name;
+
+    /// Fingerprint of the element each stream was loaded from; empty if not loaded from XML.
+    std::vector<std::uint64_t> m_fingerprints;
+
+    /// Options the fingerprinted streams were resolved with.
+    IntervalResolverOptions m_intervals{};
+    KeywordParsing m_keywords{KeywordParsing::permissive};
+};
+
+/// Stream set using the default allocator.
+template<XmlNodeLike Node>
+using StreamSet = BasicStreamSet<Node>;
+
+/**
+ * @class InternedStreamSet
+ * @brief A stream set whose strings are interned in a pool it owns.
+ *
+ * Values such as reference times, intervals, precisions and I/O types
+ * repeat across most streams of a large document; each distinct value is
+ * stored once, every stream field is an `InternedString`, and comparing two
+ * fields is a pointer compare.
+ *
+ * The pool lives on the heap, so the set can be moved without invalidating
+ * its streams. It is append-only, so every load and reload builds the new
+ * streams in a fresh pool and releases the old one; a long-running set that
+ * is reloaded repeatedly holds only the values of its current document.
+ *
+ * @tparam Node XML node adapter type satisfying the `XmlNodeLike` concept.
+ */
+template<XmlNodeLike Node>
+class InternedStreamSet {
+public:
+    using set_type       = BasicStreamSet<Node, InterningAllocator<char>>;
+    using stream_type    = typename set_type::stream_type;
+    using container_type = typename set_type::container_type;
+    using const_iterator = typename set_type::const_iterator;
+
+    InternedStreamSet()
+        : m_pool{std::make_unique<StringPool>()},
+          m_set{InterningAllocator<char>{*m_pool}} {}
+
+    /** @copydoc BasicStreamSet::load_from_xml */
+    void load_from_xml(const Node& streams_root, const LoadOptions& options = {}) {
+        auto pool = std::make_unique<StringPool>();
+        set_type set{InterningAllocator<char>{*pool}};
+        set.load_from_xml(streams_root, options);
+        replace(std::move(set), std::move(pool));
+    }
+
+    /** @copydoc BasicStreamSet::load_valid_from_xml */
+    [[nodiscard]] std::vector<StreamDiagnostic> load_valid_from_xml(const Node& streams_root,
+                                                                    const LoadOptions& options = {}) {
+        auto pool = std::make_unique<StringPool>();
+        set_type set{InterningAllocator<char>{*pool}};
+        auto diagnostics = set.load_valid_from_xml(streams_root, options);
+        replace(std::move(set), std::move(pool));
+        return diagnostics;
+    }
+
+    /**
+     * @copydoc BasicStreamSet::reload
+     *
+     * Kept streams are re-interned into the fresh pool, which costs one
+     * lookup per value but no re-resolution.
+     */
+    StreamChangeSet reload(const Node& streams_root, const LoadOptions& options = {}) {
+        auto pool = std::make_unique<StringPool>();
+        auto changes = m_set.reload(streams_root, options, InterningAllocator<char>{*pool});
+        m_pool = std::move(pool);
+        return changes;
+    }
+
+    /** @copydoc BasicStreamSet::find */
+    [[nodiscard]] const stream_type* find(std::string_view name) const noexcept { return m_set.find(name); }
+
+    /** @return True if a stream with the given name was loaded. */
+    [[nodiscard]] bool contains(std::string_view name) const noexcept { return m_set.contains(name); }
+
+    /** @return All loaded streams. */
+    [[nodiscard]] const container_type& streams() const noexcept { return m_set.streams(); }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return m_set.begin(); }
+    [[nodiscard]] const_iterator end() const noexcept { return m_set.end(); }
+
+    /** @return The number of loaded streams. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_set.size(); }
+
+    /** @return True if no streams are loaded. */
+    [[nodiscard]] bool empty() const noexcept { return m_set.empty(); }
+
+    /** @return The underlying set, e.g. for `serialize`. */
+    [[nodiscard]] const set_type& stream_set() const noexcept { return m_set; }
+
+    /** @return The pool holding every string of the loaded streams. */
+    [[nodiscard]] const StringPool& pool() const noexcept { return *m_pool; }
+
+private:
+    /// Installs a set built in `pool`, releasing the old streams before the old pool.
+    void replace(set_type set, std::unique_ptr<StringPool> pool) noexcept {
+        m_set  = std::move(set);
+        m_pool = std::move(pool);
+    }
+
+    // Declared first so it outlives the streams that point into it.
+    std::unique_ptr<StringPool> m_pool;
+    set_type m_set;
+};
+
+namespace pmr {
+
+/// Stream set allocating from a `std::pmr::memory_resource`.
+template<XmlNodeLike Node>
+using StreamSet = BasicStreamSet<Node, std::pmr::polymorphic_allocator<char>>;
+
+} // namespace pmr
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_SET_HPP
@@ -0,0 +1,285 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAM_TABLE_HPP
+#define XML_STREAM_PARSER_STREAM_TABLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "stream_members.hpp"
+#include "xml_pull_parser.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @class StreamTable
+ * @brief The stream elements of a streams.xml document, read without a DOM.
+ *
+ * A single `XmlPullParser` pass keeps the root element, the
+ * `<immutable_stream>` and `<stream>` elements directly below it and, by
+ * default, their member children (`<file>`, `<var>`, `<var_array>`,
+ * `<var_struct>`, `<stream>`). Anything else is skipped with
+ * `XmlPullParser::skip_children`, which only scans for tag boundaries.
+ * Every kept element name and attribute is copied into one text block, with
+ * attribute names stored once. With `Contents::streams` member children are
+ * skipped as well and the table's size is proportional to the stream
+ * attributes rather than to the document; streams loaded from such a table
+ * have empty member lists.
+ *
+ * `StreamTable::Node` satisfies `XmlNodeView`, so the table plugs into
+ * `StreamIndex`, `IntervalResolver` and `StreamSet` unchanged; `stream:`
+ * references are resolved by that second pass over the table. The source
+ * text may be released once the table is built; nodes refer to the table
+ * object itself, which must not be moved while they are in use.
+ */
+class StreamTable {
+    struct Span {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    struct Attribute {
+        Span name;
+        Span value;
+    };
+
+    struct Element {
+        Span name;
+        std::uint32_t first_attribute;
+        std::uint32_t attribute_count;
+
+        /// Index of the parent element; the root is its own parent.
+        std::uint32_t parent;
+
+        /// One past the index of the element's last descendant.
+        std::uint32_t end;
+
+        /// Byte offset of the element name in the source document.
+        std::uint32_t source_offset;
+    };
+
+public:
+    /** @brief Which elements a table keeps besides the root and the streams. */
+    enum class Contents : std::uint8_t {
+        streams,             ///< Nothing else; streams have no children
+        streams_and_members  ///< Also each stream's member children
+    };
+
+    /**
+     * @class Node
+     * @brief A view of the root or of one stream element of a `StreamTable`.
+     *
+     * The root's children are the kept stream elements; a stream's children
+     * are its kept member elements. Views are valid for the lifetime of the
+     * table.
+     */
+    class Node {
+    public:
+        Node() = default;
+
+        /** @return The element's attributes as `(name, value)` views, in document order. */
+        [[nodiscard]] auto get_attributes() const noexcept {
+            const auto& element = m_table->m_elements[m_index];
+            return std::span{m_table->m_attributes}.subspan(element.first_attribute, element.attribute_count)
+                 | std::views::transform([table = m_table](const Attribute& attr) {
+                       return std::pair{table->text(attr.name), table->text(attr.value)};
+                   });
+        }
+
+        /** @return The attribute's value, or an empty view if missing. */
+        [[nodiscard]] std::string_view get_attribute(std::string_view key) const noexcept {
+            for (const auto& [name, value] : get_attributes())
+                if (name == key)
+                    return value;
+            return {};
+        }
+
+        /** @return True if the element has the attribute. */
+        [[nodiscard]] bool has_attribute(std::string_view key) const noexcept {
+            return std::ranges::any_of(get_attributes(), [&](const auto& attr) { return attr.first == key; });
+        }
+
+        /**
+         * @brief The kept child elements with the given name.
+         * @param tag The element name; must outlive the returned range.
+         */
+        [[nodiscard]] auto children(std::string_view tag) const noexcept {
+            // Descendants directly follow their ancestor.
+            return std::views::iota(m_index + 1, std::size_t{m_table->m_elements[m_index].end})
+                 | std::views::filter([table = m_table, parent = m_index, tag](std::size_t i) {
+                       const auto& element = table->m_elements[i];
+                       return element.parent == parent && table->text(element.name) == tag;
+                   })
+                 | std::views::transform([table = m_table](std::size_t i) { return Node{table, i}; });
+        }
+
+        /** @return The element name. */
+        [[nodiscard]] std::string_view name() const noexcept {
+            return m_table->text(m_table->m_elements[m_index].name);
+        }
+
+        /** @return The byte offset of the element name in the document the table was built from. */
+        [[nodiscard]] std::optional<std::size_t> source_offset() const noexcept {
+            return m_table->m_elements[m_index].source_offset;
+        }
+
+    private:
+        friend class StreamTable;
+
+        Node(const StreamTable* table, std::size_t index) noexcept : m_table{table}, m_index{index} {}
+
+        const StreamTable* m_table{nullptr};
+
+        /// Position in `m_elements`; 0 is the root.
+        std::size_t m_index{0};
+    };
+
+    /**
+     * @brief Builds the table from a complete streams.xml document.
+     * @param document The document text; may be released once the table is built.
+     * @param contents Whether to keep the streams' member children.
+     * @throws std::runtime_error if the document is not well-formed, has no
+     *         root element, or exceeds the table's 4 GiB text limit.
+     */
+    explicit StreamTable(std::string_view document, Contents contents = Contents::streams_and_members) {
+        XmlPullParser parser{document};
+        bool have_root = false;
+        std::uint32_t stream = 0;
+
+        for (auto event = parser.next(); event != XmlPullParser::Event::end_document; event = parser.next()) {
+            if (event != XmlPullParser::Event::start_element)
+                continue;
+            const auto depth = parser.depth();
+            if (depth == 1 && !have_root) {
+                have_root = true;
+                add_element(parser, document, 0);
+                continue;
+            }
+            if (depth == 2 && (parser.name() == "immutable_stream" || parser.name() == "stream")) {
+                stream = add_element(parser, document, 0);
+                ++m_stream_count;
+                if (contents == Contents::streams_and_members)
+                    continue;
+            } else if (depth == 3 && is_member(parser.name())) {
+                add_element(parser, document, stream);
+            }
+            parser.skip_children();
+        }
+
+        if (!have_root)
+            throw std::runtime_error("XML document has no root element");
+        m_elements.front().end = static_cast<std::uint32_t>(m_elements.size());
+        m_text.shrink_to_fit();
+        m_attributes.shrink_to_fit();
+        m_elements.shrink_to_fit();
+    }
+
+    StreamTable(const StreamTable&) = delete;
+    StreamTable& operator=(const StreamTable&) = delete;
+    StreamTable(StreamTable&&) noexcept = default;
+    StreamTable& operator=(StreamTable&&) noexcept = default;
+
+    /** @return The document's root element, normally `<streams>`. */
+    [[nodiscard]] Node root() const noexcept { return Node{this, 0}; }
+
+    /** @return The number of stream elements kept. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_stream_count; }
+
+    /** @return Bytes held by the table, excluding the object itself. */
+    [[nodiscard]] std::size_t memory_usage() const noexcept {
+        return m_text.capacity() + m_attributes.capacity() * sizeof(Attribute)
+             + m_elements.capacity() * sizeof(Element) + m_names.capacity() * sizeof(Span);
+    }
+
+private:
+    [[nodiscard]] std::string_view text(Span span) const noexcept {
+        return std::string_view{m_text}.substr(span.offset, span.size);
+    }
+
+    Span append(std::string_view s) {
+        if (m_text.size() + s.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::runtime_error("Stream table exceeds the 4 GiB text limit");
+        const Span span{static_cast<std::uint32_t>(m_text.size()), static_cast<std::uint32_t>(s.size())};
+        m_text.append(s);
+        return span;
+    }
+
+    /// Element and attribute names repeat on every stream; store each once.
+    Span intern(std::string_view name) {
+        for (const auto& span : m_names)
+            if (text(span) == name)
+                return span;
+        return m_names.emplace_back(append(name));
+    }
+
+    static bool is_member(std::string_view name) noexcept {
+        return std::ranges::any_of(MEMBER_KINDS, [&](MemberKind kind) { return to_string(kind) == name; });
+    }
+
+    /// Appends the parser's current element as the last child of `parent`; returns its index.
+    std::uint32_t add_element(const XmlPullParser& parser, std::string_view document, std::uint32_t parent) {
+        const auto attributes = parser.attributes();
+        const auto index = static_cast<std::uint32_t>(m_elements.size());
+        m_elements.push_back({intern(parser.name()),
+                              static_cast<std::uint32_t>(m_attributes.size()),
+                              static_cast<std::uint32_t>(attributes.size()),
+                              parent,
+                              index + 1,
+                              static_cast<std::uint32_t>(parser.name().data() - document.data())});
+        if (index != 0)
+            m_elements[parent].end = index + 1;
+        for (const auto& attr : attributes)
+            m_attributes.push_back({intern(attr.name), append(attr.value)});
+        return index;
+    }
+
+    std::string m_text;
+    std::vector<Attribute> m_attributes;
+
+    /// The root first, then the stream elements in document order, each
+    /// followed by its member elements.
+    std::vector<Element> m_elements;
+
+    std::size_t m_stream_count{0};
+
+    /// Distinct element and attribute names in `m_text`.
+    std::vector<Span> m_names;
+};
+
+/**
+ * @brief Reads a streams.xml file into a `StreamTable` without building a DOM.
+ *
+ * The file is mapped read-only and unmapped once the table is built.
+ *
+ * @param path     The streams.xml file.
+ * @param contents Whether to keep the streams' member children.
+ *
+ * @throws std::runtime_error if the file cannot be mapped, is empty, is not
+ *         well-formed XML, or has no `<streams>` root element.
+ */
+inline StreamTable load_stream_table(const std::string& path,
+                                     StreamTable::Contents contents = StreamTable::Contents::streams_and_members) {
+    const auto mapping = MappedFile::open(path, MappedFile::Mode::read_only);
+    if (mapping.empty())
+        throw std::runtime_error(std::format("Streams file '{}' is empty", path));
+
+    StreamTable table{std::string_view{static_cast<const char*>(mapping.data()), mapping.size()}, contents};
+    if (table.root().name() != "streams")
+        throw std::runtime_error(std::format("Streams file '{}' has no <streams> element", path));
+    return table;
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAM_TABLE_HPP
@@ -0,0 +1,113 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STREAMS_FILE_HPP
+#define XML_STREAM_PARSER_STREAMS_FILE_HPP
+
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <pugixml.hpp>
+
+#include "mapped_file.hpp"
+#include "pugi_xml_adapter.hpp"
+#include "pugi_xml_view_adapter.hpp"
+
+namespace xml_stream_parser {
+
+/**
+ * @class StreamsFile
+ * @brief A streams.xml file mapped into memory and parsed in place.
+ *
+ * The file is mapped private and writable, so pugixml's in-situ parser can
+ * terminate and unescape strings directly in the mapping. Pages it touches
+ * are copied on write by the kernel; the file on disk is never modified and
+ * no user-space copy of the file is made.
+ *
+ * The object owns both the mapping and the document. Adapters obtained from
+ * `root()` / `root_view()` stay valid for its lifetime. A moved-from
+ * object has an empty root and no document.
+ *
+ * Instances are created with `load_streams_file()`. Requires POSIX `mmap`.
+ */
+class StreamsFile {
+public:
+    StreamsFile(StreamsFile&&) noexcept = default;
+    StreamsFile& operator=(StreamsFile&&) noexcept = default;
+
+    /** @return The `<streams>` element wrapped in the owning adapter; empty if moved from. */
+    [[nodiscard]] PugiXmlAdapter root() const noexcept {
+        return PugiXmlAdapter{streams_node()};
+    }
+
+    /** @return The `<streams>` element wrapped in the allocation-free view adapter; empty if moved from. */
+    [[nodiscard]] PugiXmlViewAdapter root_view() const noexcept {
+        return PugiXmlViewAdapter{streams_node()};
+    }
+
+    /** @return The parsed document. Must not be called on a moved-from object. */
+    [[nodiscard]] const pugi::xml_document& document() const noexcept { return *m_document; }
+
+    /** @return The size of the mapped file in bytes. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_mapping.size(); }
+
+private:
+    friend StreamsFile load_streams_file(MappedFile mapping, const std::string& path);
+
+    explicit StreamsFile(MappedFile mapping)
+        : m_mapping{std::move(mapping)}, m_document{std::make_unique<pugi::xml_document>()} {}
+
+    [[nodiscard]] pugi::xml_node streams_node() const noexcept {
+        return m_document ? m_document->child("streams") : pugi::xml_node{};
+    }
+
+    // Declared first so the document, which points into it, is destroyed first.
+    MappedFile m_mapping;
+    std::unique_ptr<pugi::xml_document> m_document;
+};
+
+/**
+ * @brief Parses an already mapped streams.xml file in place.
+ *
+ * @param mapping A `MappedFile::Mode::copy_on_write` mapping of the file.
+ * @param path    The file's path, used in error messages.
+ * @return The parsed file, owning `mapping`.
+ * @throws std::runtime_error if the file is empty, is not well-formed XML,
+ *         or has no `<streams>` element.
+ */
+inline StreamsFile load_streams_file(MappedFile mapping, const std::string& path) {
+    if (mapping.empty())
+        throw std::runtime_error(std::format("Streams file '{}' is empty", path));
+
+    StreamsFile file{std::move(mapping)};
+    const auto result = file.m_document->load_buffer_inplace(file.m_mapping.data(),
+                                                             file.m_mapping.size());
+    if (!result)
+        throw std::runtime_error(std::format(
+            "Failed to parse '{}' at offset {}: {}",
+            path, static_cast<std::ptrdiff_t>(result.offset), result.description()));
+
+    if (!file.m_document->child("streams"))
+        throw std::runtime_error(std::format(
+            "Streams file '{}' has no <streams> element", path));
+
+    return file;
+}
+
+/**
+ * @brief Maps a streams.xml file and parses it in place.
+ *
+ * @param path Path to the streams.xml file.
+ * @return The mapped and parsed file.
+ * @throws std::runtime_error if the file cannot be opened or mapped, is
+ *         empty, is not well-formed XML, or has no `<streams>` element.
+ */
+inline StreamsFile load_streams_file(const std::string& path) {
+    return load_streams_file(MappedFile::open(path, MappedFile::Mode::copy_on_write), path);
+}
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STREAMS_FILE_HPP
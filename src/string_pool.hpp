@@ -0,0 +1,235 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_STRING_POOL_HPP
+#define XML_STREAM_PARSER_STRING_POOL_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+#include "stream_index.hpp"
+
+namespace xml_stream_parser {
+
+class StringPool;
+
+template<typename T>
+class InterningAllocator;
+
+/**
+ * @class InternedString
+ * @brief A string stored once in a `StringPool`.
+ *
+ * Holds a view of the pooled characters plus the pool itself, so it can be
+ * reassigned. Within one pool equal strings share storage, so comparing two
+ * interned strings is a pointer and length compare. Comparison with a
+ * `std::string_view`, or with a string from another pool, compares contents.
+ *
+ * Copy assignment keeps the target's pool and re-interns if the source came
+ * from a different one, matching allocator-aware container semantics.
+ */
+class InternedString {
+public:
+    using allocator_type = InterningAllocator<char>;
+
+    InternedString() = default;
+
+    explicit InternedString(const allocator_type& alloc) noexcept;
+    InternedString(std::string_view value, const allocator_type& alloc);
+    InternedString(const InternedString& other, const allocator_type& alloc);
+    InternedString(InternedString&& other, const allocator_type& alloc);
+
+    InternedString(const InternedString&) = default;
+    InternedString(InternedString&&) noexcept = default;
+
+    InternedString& operator=(const InternedString& other) {
+        if (m_pool && m_pool != other.m_pool)
+            return assign(other.m_view);
+        m_view = other.m_view;
+        m_pool = other.m_pool;
+        return *this;
+    }
+
+    InternedString& operator=(std::string_view value) { return assign(value); }
+
+    /** @brief Interns `value` in this string's pool. */
+    InternedString& assign(std::string_view value);
+
+    [[nodiscard]] const char* data() const noexcept { return m_view.data(); }
+    [[nodiscard]] std::size_t size() const noexcept { return m_view.size(); }
+    [[nodiscard]] bool empty() const noexcept { return m_view.empty(); }
+    [[nodiscard]] char operator[](std::size_t i) const noexcept { return m_view[i]; }
+    [[nodiscard]] auto begin() const noexcept { return m_view.begin(); }
+    [[nodiscard]] auto end() const noexcept { return m_view.end(); }
+
+    [[nodiscard]] std::string_view view() const noexcept { return m_view; }
+    operator std::string_view() const noexcept { return m_view; }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept;
+
+    /// Identity compare within one pool; strings from different pools compare contents.
+    [[nodiscard]] friend bool operator==(const InternedString& a, const InternedString& b) noexcept {
+        if (a.m_pool != b.m_pool)
+            return a.m_view == b.m_view;
+        return a.m_view.data() == b.m_view.data() && a.m_view.size() == b.m_view.size();
+    }
+
+    [[nodiscard]] friend bool operator==(const InternedString& a, std::string_view b) noexcept {
+        return a.m_view == b;
+    }
+
+private:
+    friend class StringPool;
+
+    InternedString(std::string_view pooled, StringPool* pool) noexcept
+        : m_view{pooled}, m_pool{pool} {}
+
+    std::string_view m_view;
+    StringPool* m_pool{nullptr};
+};
+
+/**
+ * @class StringPool
+ * @brief Thread-safe store of distinct strings.
+ *
+ * Each distinct value is copied once into an append-only arena and never
+ * moves, so interned views stay valid for the pool's lifetime. The empty
+ * string is never stored.
+ */
+class StringPool {
+public:
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /** @return The pooled copy of `value`. */
+    [[nodiscard]] InternedString intern(std::string_view value) {
+        if (value.empty())
+            return InternedString{std::string_view{}, this};
+
+        const std::scoped_lock lock{m_mutex};
+        if (const auto it = m_strings.find(value); it != m_strings.end())
+            return InternedString{*it, this};
+
+        auto* storage = static_cast<char*>(m_storage.allocate(value.size(), alignof(char)));
+        std::char_traits<char>::copy(storage, value.data(), value.size());
+        m_bytes += value.size();
+        return InternedString{*m_strings.emplace(storage, value.size()).first, this};
+    }
+
+    /** @return The number of distinct strings stored. */
+    [[nodiscard]] std::size_t size() const {
+        const std::scoped_lock lock{m_mutex};
+        return m_strings.size();
+    }
+
+    /** @return The number of characters stored. */
+    [[nodiscard]] std::size_t bytes() const {
+        const std::scoped_lock lock{m_mutex};
+        return m_bytes;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::pmr::monotonic_buffer_resource m_storage;
+    std::unordered_set<std::string_view, StringHash, std::equal_to<>> m_strings;
+    std::size_t m_bytes{0};
+};
+
+/**
+ * @class InterningAllocator
+ * @brief Allocator that selects `InternedString` storage from a `StringPool`.
+ *
+ * Memory for containers is taken from the default heap; the allocator's
+ * role is to carry the pool. Like `std::pmr::polymorphic_allocator` it
+ * performs uses-allocator construction, so containers of streams hand the
+ * pool down to every string they construct.
+ */
+template<typename T>
+class InterningAllocator {
+public:
+    using value_type = T;
+
+    // Containers moved or swapped between sets take the source's pool with them.
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    explicit InterningAllocator(StringPool& pool) noexcept : m_pool{&pool} {}
+
+    /** @param pool The pool, or nullptr for an allocator that cannot intern. */
+    explicit InterningAllocator(StringPool* pool) noexcept : m_pool{pool} {}
+
+    template<typename U>
+    InterningAllocator(const InterningAllocator<U>& other) noexcept : m_pool{other.pool()} {}
+
+    [[nodiscard]] T* allocate(std::size_t n) { return std::allocator<T>{}.allocate(n); }
+    void deallocate(T* p, std::size_t n) noexcept { std::allocator<T>{}.deallocate(p, n); }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        std::uninitialized_construct_using_allocator(p, *this, std::forward<Args>(args)...);
+    }
+
+    /** @return The pool strings are interned in. */
+    [[nodiscard]] StringPool* pool() const noexcept { return m_pool; }
+
+    template<typename U>
+    [[nodiscard]] bool operator==(const InterningAllocator<U>& other) const noexcept {
+        return m_pool == other.pool();
+    }
+
+private:
+    StringPool* m_pool;
+};
+
+inline InternedString::InternedString(const allocator_type& alloc) noexcept
+    : m_pool{alloc.pool()} {}
+
+inline InternedString::InternedString(std::string_view value, const allocator_type& alloc)
+    : InternedString{alloc.pool()->intern(value)} {}
+
+inline InternedString::InternedString(const InternedString& other, const allocator_type& alloc)
+    : InternedString{other.m_pool == alloc.pool() ? other : alloc.pool()->intern(other.m_view)} {}
+
+inline InternedString::InternedString(InternedString&& other, const allocator_type& alloc)
+    : InternedString{std::as_const(other), alloc} {}
+
+inline InternedString& InternedString::assign(std::string_view value) {
+    if (!m_pool)
+        throw std::logic_error("InternedString assigned without a StringPool");
+    return *this = m_pool->intern(value);
+}
+
+inline InternedString::allocator_type InternedString::get_allocator() const noexcept {
+    return allocator_type{m_pool};
+}
+
+/**
+ * @brief The string type stored by streams using `Allocator`.
+ *
+ * `std::basic_string` for ordinary allocators, `InternedString` for
+ * `InterningAllocator`.
+ */
+template<typename Allocator>
+struct stream_string {
+    using type = std::basic_string<char, std::char_traits<char>, Allocator>;
+};
+
+template<>
+struct stream_string<InterningAllocator<char>> {
+    using type = InternedString;
+};
+
+template<typename Allocator>
+using stream_string_t = typename stream_string<Allocator>::type;
+
+} // namespace xml_stream_parser
+
+#endif // XML_STREAM_PARSER_STRING_POOL_HPP
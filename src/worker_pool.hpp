@@ -0,0 +1,66 @@
+#pragma once
+#ifndef XML_STREAM_PARSER_WORKER_POOL_HPP
+#define XML_STREAM_PARSER_WORKER_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace xml_stream_parser::detail {
+
+/**
+ * @brief Runs `work(w)` once for every worker index `w` in `[0, workers)`.
+ *
+ * Worker 0 runs on the calling thread and the others on threads of their
+ * own; returns once all have finished. A worker that throws stops, the
+ * others carry on, and afterwards the exception of the lowest-numbered
+ * failing worker is rethrown.
+ *
+ * @param workers At least 1.
+ */
+template<typename F>
+void run_workers(std::size_t workers, F&& work) {
+    std::vector<std::exception_ptr> failures(workers);
+    auto guarded = [&](std::size_t w) {
+        try {
+            work(w);
+        } catch (...) {
+            failures[w] = std::current_exception();
+        }
+    };
+
+    {
+        std::vector<std::jthread> pool;
+        pool.reserve(workers - 1);
+        for (std::size_t w = 1; w < workers; ++w)
+            pool.emplace_back(guarded, w);
+        guarded(0);
+    }
+
+    for (const auto& failure : failures)
+        if (failure)
+            std::rethrow_exception(failure);
+}
+
+/**
+ * @brief Calls `task(i)` for every `i` in `[0, count)` on up to `workers` threads.
+ *
+ * Indices are handed out one at a time from a shared counter, so uneven
+ * tasks balance themselves. Exceptions are reported as by `run_workers`.
+ *
+ * @param workers At least 1.
+ */
+template<typename F>
+void for_each_index(std::size_t count, std::size_t workers, F&& task) {
+    std::atomic<std::size_t> next{0};
+    run_workers(workers, [&](std::size_t) {
+        for (auto i = next++; i < count; i = next++)
+            task(i);
+    });
+}
+
+} // namespace xml_stream_parser::detail
+
+#endif // XML_STREAM_PARSER_WORKER_POOL_HPP
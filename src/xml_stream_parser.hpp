@@ -2,10 +2,32 @@
 #define XML_STREAM_PARSER_XML_STREAM_PARSER_HPP
 #pragma once
 
+#include "embedded_streams.hpp"
 #include "filesystem.hpp"
+#include "hash.hpp"
+#include "filename_template.hpp"
 #include "pugi_xml_adapter.hpp"
+#include "pugi_xml_view_adapter.hpp"
 #include "parse.hpp"
+#include "instrumentation.hpp"
+#include "interval.hpp"
+#include "interval_resolver.hpp"
+#include "member_files.hpp"
+#include "output_paths.hpp"
+#include "stream_attributes.hpp"
+#include "stream_error.hpp"
 #include "stream.hpp"
+#include "stream_index.hpp"
+#include "stream_keywords.hpp"
+#include "stream_members.hpp"
+#include "stream_set.hpp"
+#include "stream_table.hpp"
+#include "streams_file.hpp"
+#include "stream_cache.hpp"
+#include "stream_serialization.hpp"
+#include "string_pool.hpp"
+#include "worker_pool.hpp"
+#include "xml_pull_parser.hpp"
 
 
 #endif // XML_STREAM_PARSER_XML_STREAM_PARSER_HPP
@@ -0,0 +1,153 @@
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <ut.hpp>
+#include "embedded_streams.hpp"
+#include "stream_serialization.hpp"
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+constexpr std::string_view STREAMS_XML = R"(<?xml version="1.0"?>
+<!-- embedded at build time -->
+<streams>
+    <immutable_stream name="restart" type="input output" filename_template="restart.$Y-$M-$D.nc"
+                      input_interval="initial_only" output_interval="1_00:00:00" clobber_mode="overwrite">
+        <var name="xtime"/>
+    </immutable_stream>
+    <stream name="history" type="output" filename_template="history.$Y-$M-$D.nc"
+            output_interval="6:00:00" precision="single" io_type="pnetcdf,cdf5">
+        <stream name="restart"/>
+        <var name="u"/>
+        <file name="history_vars.txt"/>
+    </stream>
+    <stream name="diagnostics" type="output" filename_template="diag.$Y-$M-$D.nc"
+            filename_interval="output_interval" output_interval="stream:history:output_interval"/>
+    <stream name="chained" type='output' filename_template="chain.nc"
+            output_interval="stream:diagnostics:output_interval"><![CDATA[<var name="ignored"/>]]></stream>
+    <stream type="output"/>
+</streams>
+)";
+
+constexpr auto STREAMS = embed_streams<STREAMS_XML>();
+
+static_assert(STREAMS.size() == 4);
+static_assert(STREAMS[0].stream_id == "restart" && STREAMS[0].immutable == 1);
+static_assert(STREAMS.find("chained")->output_interval == "6:00:00");
+static_assert(STREAMS.find("diagnostics")->filename_interval == "6:00:00");
+static_assert(STREAMS.find("history")->type == 2);
+static_assert(!STREAMS.find("missing").has_value());
+
+constexpr std::string_view BAD_REFERENCE = R"(
+<streams>
+    <stream name="a" type="output" output_interval="stream:b:output_interval"/>
+</streams>
+)";
+
+constexpr std::string_view BAD_NESTING = R"(<streams><stream name="a" type="output"></streams>)";
+
+constexpr std::string_view CYCLE = R"(
+<streams>
+    <stream name="a" type="output" output_interval="stream:b:output_interval"/>
+    <stream name="b" type="output" output_interval="stream:a:output_interval"/>
+</streams>
+)";
+
+/// True if `Xml` resolves in a constant expression, i.e. would compile when embedded.
+template<const std::string_view& Xml>
+constexpr bool embeds = requires {
+    typename std::integral_constant<std::size_t, measure_embedded_streams(Xml).streams>;
+    typename std::bool_constant<(EmbeddedStreams<measure_embedded_streams(Xml).streams,
+                                                 measure_embedded_streams(Xml).member_bytes>{Xml},
+                                 true)>;
+};
+
+static_assert(embeds<STREAMS_XML>);
+static_assert(!embeds<BAD_REFERENCE>);
+static_assert(!embeds<BAD_NESTING>);
+static_assert(!embeds<CYCLE>);
+
+/// Resolves a document at run time, where errors throw.
+StreamSet<PugiXmlViewAdapter> restore_at_runtime(std::string_view xml, IntervalResolverOptions options = {}) {
+    const auto size = measure_embedded_streams(xml);
+    if (size.streams != 3 || size.member_bytes != 0)
+        throw std::logic_error("unexpected test document size");
+    return restore_stream_set<PugiXmlViewAdapter>(EmbeddedStreams<3, 0>{xml, options});
+}
+
+} // namespace
+
+struct EmbeddedStreamsFixture {
+    pugi::xml_document doc;
+    StreamSet<PugiXmlViewAdapter> loaded;
+
+    EmbeddedStreamsFixture() {
+        doc.load_string(std::string{STREAMS_XML}.c_str());
+        loaded.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+    }
+};
+
+void test_embedded_streams() {
+    using namespace boost::ut::bdd;
+    "embedded streams"_test = [] {
+        given("a document resolved at compile time") = [] {
+            const EmbeddedStreamsFixture fixture;
+
+            then("its streams should match a runtime load") = [&] {
+                const auto restored = restore_stream_set<PugiXmlViewAdapter>(STREAMS);
+                const bool same = serialize(restored) == serialize(fixture.loaded);
+                expect(same);
+                expect(restored.find("chained")->get_output_interval() == "6:00:00");
+            };
+
+            then("member lists should be grouped as in a runtime load") = [&] {
+                expect(STREAMS.find("history")->members == fixture.loaded.find("history")->get_members().encoded());
+                expect(STREAMS.find("chained")->members.empty());
+            };
+        };
+
+        given("documents with configuration errors") = [] {
+            constexpr std::string_view deep = R"(
+                <streams>
+                    <stream name="a" type="output" output_interval="stream:b:output_interval"/>
+                    <stream name="b" type="output" output_interval="stream:c:output_interval"/>
+                    <stream name="c" type="output" output_interval="1:00:00"/>
+                </streams>)";
+
+            then("resolution errors should be reported as at load time") = [&] {
+                expect(throws<StreamIntervalError>([&] { (void)restore_at_runtime(deep, {.strict = true}); }));
+                expect(throws<StreamIntervalError>([&] { (void)restore_at_runtime(deep, {.max_depth = 1}); }));
+                constexpr std::string_view one_hop = R"(
+                    <streams>
+                        <stream name="a" type="output" output_interval="stream:b:output_interval"/>
+                        <stream name="b" type="output" output_interval="1:00:00"/>
+                        <stream name="c" type="output" output_interval="1:00:00"/>
+                    </streams>)";
+                expect(throws<StreamIntervalError>([&] { (void)restore_at_runtime(one_hop, {.max_depth = 0}); }));
+                expect(restore_at_runtime(deep).find("a")->get_output_interval() == "1:00:00");
+            };
+
+            then("malformed XML and literal-only values should be rejected") = [] {
+                expect(throws<std::runtime_error>([] {
+                    (void)measure_embedded_streams(R"(<streams><stream name="a"></stream>)");
+                }));
+                expect(throws<std::runtime_error>([] {
+                    (void)measure_embedded_streams(R"(<streams><stream name="a&amp;b"/></streams>)");
+                }));
+                expect(throws<std::runtime_error>([] {
+                    (void)measure_embedded_streams(R"(<streams/><streams/>)");
+                }));
+                expect(throws<std::runtime_error>([] { (void)EmbeddedStreams<0, 0>{"<other/>"}; }));
+            };
+        };
+    };
+}
+
+int main() {
+    test_embedded_streams();
+}
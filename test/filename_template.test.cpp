@@ -0,0 +1,98 @@
+#include <ut.hpp>
+#include <array>
+#include "filename_template.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+struct FilenameTemplateFixture {
+    TemplateTime time{.year = 2, .month = 3, .day = 4, .day_of_year = 63,
+                      .hour = 5, .minute = 6, .second = 7};
+};
+
+void test_filename_template() {
+    using namespace boost::ut::bdd;
+    "filename template expansion"_test = [] {
+        given("a template using every MPAS time field") = [] {
+            const FilenameTemplateFixture fixture;
+            const FilenameTemplate tmpl{"history.$Y-$M-$D_$h.$m.$s.$d.nc"};
+
+            when("it is expanded into a caller buffer") = [&] {
+                std::array<char, 64> buffer{};
+                const auto name = tmpl.expand(buffer, fixture.time);
+
+                then("every field should be zero-padded to its MPAS width") = [&] {
+                    expect(eq(std::string(name), "history.0002-03-04_05.06.07.063.nc"_s));
+                };
+
+                then("the result should view the caller's buffer") = [&] {
+                    expect(name.data() == buffer.data());
+                };
+            };
+
+            when("the buffer is sized by max_expanded_size") = [&] {
+                const TemplateTime extreme{.year = -2147483647 - 1, .month = 12, .day = 31,
+                                           .day_of_year = 366, .hour = 23, .minute = 59, .second = 59};
+
+                then("any time should fit") = [&] {
+                    std::string buffer(tmpl.max_expanded_size(), '\0');
+                    expect(nothrow([&] { (void)tmpl.expand(std::span{buffer}, extreme); }));
+                };
+            };
+
+            when("the buffer is too small") = [&] {
+                std::array<char, 8> buffer{};
+
+                then("expansion should throw a length_error") = [&] {
+                    expect(throws<std::length_error>([&] { (void)tmpl.expand(buffer, fixture.time); }));
+                };
+            };
+        };
+
+        given("templates with unusual contents") = [] {
+            const FilenameTemplateFixture fixture;
+
+            then("years past 9999 and negative years should not be truncated") = [&] {
+                const FilenameTemplate tmpl{"$Y"};
+                expect(eq(tmpl.expand(TemplateTime{.year = 12345}), "12345"_s));
+                expect(eq(tmpl.expand(TemplateTime{.year = -5}), "-0005"_s));
+            };
+
+            then("unknown tokens and a trailing '$' should be kept literally") = [&] {
+                const FilenameTemplate tmpl{"a$xb$Y$"};
+                expect(eq(tmpl.expand(fixture.time), "a$xb0002$"_s));
+            };
+
+            then("a template without fields should be constant") = [&] {
+                const FilenameTemplate tmpl{"init.nc"};
+                expect(tmpl.is_constant());
+                expect(eq(tmpl.expand(fixture.time), "init.nc"_s));
+            };
+
+            then("an empty template should expand to an empty name") = [&] {
+                expect(eq(FilenameTemplate{}.expand(fixture.time), ""_s));
+            };
+        };
+
+        given("a stream loaded from XML") = [] {
+            const FilenameTemplateFixture fixture;
+            pugi::xml_document doc;
+            doc.load_string(R"(<streams><stream name="output" type="output"
+                filename_template="out/$Y/$M/output.$Y-$M-$D.nc" output_interval="1_00:00:00"/></streams>)");
+            StreamSet<PugiXmlAdapter> streams;
+            streams.load_from_xml(PugiXmlAdapter{doc.child("streams")});
+            const auto& stream = *streams.find("output");
+
+            then("the raw and compiled templates should agree") = [&] {
+                expect(eq(stream.get_filename_template(), "out/$Y/$M/output.$Y-$M-$D.nc"_s));
+                expect(eq(stream.get_compiled_filename_template().expand(fixture.time),
+                          "out/0002/03/output.0002-03-04.nc"_s));
+            };
+        };
+    };
+}
+
+int main() {
+    test_filename_template();
+}
@@ -0,0 +1,99 @@
+#include <ut.hpp>
+#include "allocation_hooks.hpp"
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+struct InstrumentationFixture {
+    pugi::xml_document doc;
+
+    InstrumentationFixture() {
+        std::string xml = "<streams>\n";
+        xml += R"(<immutable_stream name="restart" type="input output" output_interval="1_00:00:00"
+                                    filename_template="restart.$Y.nc"/>)";
+        for (int i = 0; i < 600; ++i)
+            xml += std::format(R"(<stream name="s{}" type="output" filename_template="out/s{}.$Y.nc"
+                                          output_interval="stream:restart:output_interval"/>)", i, i);
+        xml += "</streams>\n";
+        doc.load_string(xml.c_str());
+    }
+
+    [[nodiscard]] PugiXmlAdapter root() const { return PugiXmlAdapter{doc.child("streams")}; }
+};
+
+void test_instrumentation() {
+    using namespace boost::ut::bdd;
+    "load instrumentation"_test = [] {
+        static_assert(INSTRUMENTATION_ENABLED);
+
+        given("a document loaded with a stats sink") = [] {
+            const InstrumentationFixture fixture;
+            LoadStats stats;
+            StreamSet<PugiXmlAdapter> streams;
+            streams.load_from_xml(fixture.root(), LoadOptions{.stats = &stats});
+
+            then("every stream should be counted") = [&] {
+                expect(stats.streams == 601_ul);
+            };
+
+            then("the allocating phases should report allocations and bytes") = [&] {
+                expect(stats[LoadPhase::index].allocations > 0_ull);
+                expect(stats[LoadPhase::fields].allocations > 0_ull);
+                expect(stats[LoadPhase::interval_resolution].allocations > 0_ull);
+                expect(stats[LoadPhase::path_handling].bytes > 0_ull);
+            };
+
+            then("every phase should report time") = [&] {
+                for (std::size_t i = 0; i < LOAD_PHASE_COUNT; ++i)
+                    expect(stats.phases[i].elapsed.count() > 0_ll)
+                        << to_string(static_cast<LoadPhase>(i));
+            };
+
+            then("the total should sum the phases") = [&] {
+                std::uint64_t allocations = 0;
+                for (const auto& phase : stats.phases)
+                    allocations += phase.allocations;
+                expect(stats.total().allocations == allocations);
+            };
+        };
+
+        given("a parallel load") = [] {
+            const InstrumentationFixture fixture;
+            LoadStats serial;
+            LoadStats parallel;
+            StreamSet<PugiXmlAdapter> streams;
+            streams.load_from_xml(fixture.root(), LoadOptions{.stats = &serial});
+            streams.load_from_xml(fixture.root(), LoadOptions{.parallel = true, .max_threads = 2,
+                                                            .min_streams_per_thread = 100,
+                                                            .stats = &parallel});
+
+            then("worker statistics should be merged") = [&] {
+                expect(parallel.streams == 601_ul);
+                expect(parallel[LoadPhase::fields].allocations ==
+                       serial[LoadPhase::fields].allocations);
+            };
+        };
+
+        given("two loads sharing one stats sink") = [] {
+            const InstrumentationFixture fixture;
+            LoadStats once;
+            LoadStats twice;
+            StreamSet<PugiXmlAdapter> streams;
+            streams.load_from_xml(fixture.root(), LoadOptions{.stats = &once});
+            streams.load_from_xml(fixture.root(), LoadOptions{.stats = &twice});
+            streams.load_from_xml(fixture.root(), LoadOptions{.stats = &twice});
+
+            then("the statistics should accumulate") = [&] {
+                expect(twice.streams == 1202_ul);
+                expect(twice[LoadPhase::fields].allocations ==
+                       2 * once[LoadPhase::fields].allocations);
+            };
+        };
+    };
+}
+
+int main() {
+    test_instrumentation();
+}
@@ -0,0 +1,103 @@
+#include <ut.hpp>
+#include "interval.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+using namespace std::chrono_literals;
+
+static_assert(Interval::parse("1_00:00:00") == Interval::duration(24h));
+static_assert(Interval::parse("initial_only").kind() == Interval::Kind::initial_only);
+
+struct IntervalStreamFixture {
+    pugi::xml_document doc;
+
+    explicit IntervalStreamFixture(const char* xml) { doc.load_string(xml); }
+
+    [[nodiscard]] StreamSet<PugiXmlAdapter> load() const {
+        StreamSet<PugiXmlAdapter> streams;
+        streams.load_from_xml(PugiXmlAdapter{doc.child("streams")});
+        return streams;
+    }
+};
+
+void test_interval() {
+    using namespace boost::ut::bdd;
+    "interval parsing"_test = [] {
+        given("MPAS interval strings") = [] {
+            then("day and clock forms should become seconds") = [] {
+                expect(Interval::parse("1_00:00:00").seconds() == 86'400s);
+                expect(Interval::parse("6:00:00").seconds() == 21'600s);
+                expect(Interval::parse("30:00").seconds() == 1'800s);
+                expect(Interval::parse("100").seconds() == 100s);
+                expect(Interval::parse("2_12:30:15").seconds() == 2 * 86'400s + 12h + 30min + 15s);
+            };
+
+            then("year and month fields should be kept as calendar months") = [] {
+                const auto interval = Interval::parse("0001-02-03_04:00:00");
+                expect(interval.months() == 14_ll);
+                expect(interval.seconds() == 3 * 86'400s + 4h);
+                expect(Interval::parse("01-00_00:00:00").months() == 1_ll);
+            };
+
+            then("unit-suffixed integers should be accepted") = [] {
+                expect(Interval::parse("3h").seconds() == 3h);
+                expect(Interval::parse("15m").seconds() == 15min);
+                expect(Interval::parse("2d").seconds() == 48h);
+                expect(Interval::parse("30s").seconds() == 30s);
+            };
+
+            then("special tags should not be durations") = [] {
+                expect(Interval::parse("none").kind() == Interval::Kind::none);
+                expect(Interval::parse("").kind() == Interval::Kind::none);
+                expect(Interval::parse("final_only").kind() == Interval::Kind::final_only);
+                expect(!Interval::parse("initial_only").is_duration());
+            };
+        };
+
+        given("malformed interval strings") = [] {
+            then("each should be rejected") = [] {
+                for (const auto* text : {"1_", "_00:00:00", "1:2:3:4", "1-2-3-4_00:00:00", "6::00",
+                                         "-1", "1.5", "3x", "h", "abc", "1_00:00:00 ",
+                                         "stream:other:output_interval", "9999999999999"}) {
+                    expect(!Interval::try_parse(text).has_value()) << text;
+                }
+            };
+
+            then("parse should throw a StreamIntervalError") = [] {
+                expect(throws<StreamIntervalError>([] { (void)Interval::parse("1:xx"); }));
+            };
+        };
+
+        given("a stream document") = [] {
+            then("resolved intervals should be exposed as strings and parsed values") = [] {
+                const IntervalStreamFixture fixture{R"(<streams>
+                    <immutable_stream name="restart" type="input output" input_interval="initial_only"
+                                      output_interval="1_00:00:00" record_interval="6:00:00"/>
+                    <stream name="history" type="output" output_interval="stream:restart:output_interval"/>
+                </streams>)"};
+                const auto streams = fixture.load();
+                const auto& restart = *streams.find("restart");
+                const auto& history = *streams.find("history");
+
+                expect(eq(history.get_output_interval(), "1_00:00:00"_s));
+                expect(history.get_parsed_output_interval().seconds() == 24h);
+                expect(history.get_parsed_filename_interval().seconds() == 24h);
+                expect(history.get_parsed_input_interval().kind() == Interval::Kind::none);
+                expect(restart.get_parsed_input_interval().kind() == Interval::Kind::initial_only);
+                expect(restart.get_parsed_record_interval().seconds() == 6h);
+            };
+
+            then("a malformed interval should fail at load time") = [] {
+                const IntervalStreamFixture fixture{R"(<streams>
+                    <stream name="broken" type="output" output_interval="every day"/>
+                </streams>)"};
+                expect(throws<StreamIntervalError>([&] { (void)fixture.load(); }));
+            };
+        };
+    };
+}
+
+int main() {
+    test_interval();
+}
@@ -0,0 +1,151 @@
+#include <ut.hpp>
+#include "interval_resolver.hpp"
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+struct XmlIntervalResolverFixture {
+    pugi::xml_document doc;
+    StreamIndex<PugiXmlAdapter> index;
+
+    XmlIntervalResolverFixture() {
+        doc.load_string(R"(
+            <streams>
+                <immutable_stream name="base" type="output" output_interval="6:00:00" input_interval="1_00:00:00"/>
+                <stream name="hop1" type="output" output_interval="stream:base:output_interval"/>
+                <stream name="hop2" type="output" output_interval="stream:hop1:output_interval"/>
+                <stream name="hop3" type="output" output_interval="stream:hop2:output_interval"/>
+                <stream name="cycle_a" type="output" output_interval="stream:cycle_b:output_interval"/>
+                <stream name="cycle_b" type="output" output_interval="stream:cycle_c:output_interval"/>
+                <stream name="cycle_c" type="output" output_interval="stream:cycle_a:output_interval"/>
+                <stream name="fan_1" type="output" output_interval="stream:hop1:output_interval"/>
+                <stream name="fan_2" type="output" output_interval="stream:hop1:output_interval"/>
+            </streams>
+        )");
+        index.build(PugiXmlAdapter{doc.child("streams")});
+    }
+};
+
+void test_interval_resolver() {
+    using namespace boost::ut::bdd;
+    "interval resolver"_test = [] {
+        given("a document with reference chains and a three-stream cycle") = [] {
+            const XmlIntervalResolverFixture fixture;
+
+            when("references are resolved in chained mode") = [&] {
+                const IntervalResolver<PugiXmlAdapter> resolver{fixture.index};
+
+                then("literal values should pass through unchanged") = [&] {
+                    expect(eq(resolver.resolve("3:00:00", "output_interval", "x"), "3:00:00"_s));
+                };
+
+                then("multi-hop chains should resolve to the final value") = [&] {
+                    expect(eq(resolver.resolve("stream:hop3:output_interval", "output_interval", "x"),
+                              "6:00:00"_s));
+                };
+
+                then("every edge on the chain should be memoized") = [&] {
+                    expect(resolver.memo_size() == 4_ul);
+                };
+
+                then("a cycle of any length should throw a StreamIntervalError") = [&] {
+                    expect(throws<StreamIntervalError>([&] {
+                        (void)resolver.resolve("stream:cycle_b:output_interval", "output_interval", "cycle_a");
+                    }));
+                };
+
+                then("a reference from outside the cycle should also be rejected") = [&] {
+                    expect(throws<StreamIntervalError>([&] {
+                        (void)resolver.resolve("stream:cycle_a:output_interval", "output_interval", "x");
+                    }));
+                };
+            };
+
+            when("the chain is longer than the configured depth") = [&] {
+                const IntervalResolver<PugiXmlAdapter> resolver{fixture.index, {.max_depth = 2}};
+
+                then("resolution should throw a StreamIntervalError") = [&] {
+                    expect(nothrow([&] {
+                        (void)resolver.resolve("stream:hop1:output_interval", "output_interval", "x");
+                    }));
+                    expect(throws<StreamIntervalError>([&] {
+                        (void)resolver.resolve("stream:hop2:output_interval", "output_interval", "y");
+                    }));
+                };
+            };
+
+            when("the depth limit is zero") = [&] {
+                const IntervalResolver<PugiXmlAdapter> chained{fixture.index, {.max_depth = 0}};
+                const IntervalResolver<PugiXmlAdapter> strict{fixture.index, {.strict = true, .max_depth = 0}};
+
+                then("a chained reference should be rejected whether or not it is memoized") = [&] {
+                    for (int i = 0; i < 2; ++i)
+                        expect(throws<StreamIntervalError>([&] {
+                            (void)chained.resolve("stream:base:output_interval", "output_interval", "x");
+                        }));
+                };
+
+                then("a strict reference should resolve on every use") = [&] {
+                    for (int i = 0; i < 2; ++i)
+                        expect(eq(strict.resolve("stream:base:output_interval", "output_interval", "x"),
+                                  "6:00:00"_s));
+                };
+            };
+
+            when("references are resolved in strict mode") = [&] {
+                const IntervalResolver<PugiXmlAdapter> resolver{fixture.index, {.strict = true}};
+
+                then("single-hop references should resolve") = [&] {
+                    expect(eq(resolver.resolve("stream:base:output_interval", "output_interval", "hop1"),
+                              "6:00:00"_s));
+                };
+
+                then("a reference to another reference should throw a StreamIntervalError") = [&] {
+                    expect(throws<StreamIntervalError>([&] {
+                        (void)resolver.resolve("stream:hop1:output_interval", "output_interval", "fan_1");
+                    }));
+                };
+            };
+
+            when("the whole document is loaded with the default options") = [&] {
+                then("the cycle should abort the load") = [&] {
+                    StreamSet<PugiXmlAdapter> set;
+                    expect(throws<StreamIntervalError>([&] {
+                        set.load_from_xml(PugiXmlAdapter{fixture.doc.child("streams")});
+                    }));
+                };
+            };
+        };
+
+        given("a document whose chains are all acyclic") = [] {
+            pugi::xml_document doc;
+            doc.load_string(R"(
+                <streams>
+                    <immutable_stream name="base" type="output" output_interval="6:00:00"/>
+                    <stream name="hop1" type="output" output_interval="stream:base:output_interval"/>
+                    <stream name="hop2" type="output" output_interval="stream:hop1:output_interval"/>
+                </streams>
+            )");
+            const PugiXmlAdapter root{doc.child("streams")};
+
+            then("a chained load should resolve every stream") = [&] {
+                StreamSet<PugiXmlAdapter> set;
+                set.load_from_xml(root);
+                expect(eq(set.find("hop2")->get_filename_interval(), "6:00:00"_s));
+            };
+
+            then("a strict load should keep the single-hop semantics") = [&] {
+                StreamSet<PugiXmlAdapter> set;
+                expect(throws<StreamIntervalError>([&] {
+                    set.load_from_xml(root, LoadOptions{.intervals = {.strict = true}});
+                }));
+            };
+        };
+    };
+}
+
+int main() {
+    test_interval_resolver();
+}
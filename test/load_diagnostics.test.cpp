@@ -0,0 +1,188 @@
+#include <string>
+#include <vector>
+
+#include <ut.hpp>
+#include "stream_error.hpp"
+#include "stream_set.hpp"
+#include "stream_table.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+constexpr auto STREAMS_XML = R"(<streams>
+    <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00"/>
+    <stream name="history" type="output" output_interval="6:00:00"/>
+    <stream name="orphan" type="output" output_interval="stream:missing:output_interval"/>
+    <stream name="loop_a" type="output" output_interval="stream:loop_b:output_interval"/>
+    <stream name="loop_b" type="output" output_interval="stream:loop_a:output_interval"/>
+    <stream name="garbled" type="output" output_interval="6 hours"/>
+    <stream name="diagnostics" type="output" output_interval="stream:history:output_interval"/>
+    <stream name="misspelled" type="output" clobber_mode="noappend_overwrite" output_interval="1:00:00"/>
+    <stream name="anonymous_var" type="output" output_interval="1:00:00">
+        <var name="u"/>
+        <var/>
+    </stream>
+</streams>
+)";
+
+struct Expected {
+    std::string stream;
+    std::string attribute;
+    StreamErrorCode code;
+    std::size_t line;
+};
+
+/// Compares diagnostics field by field, ignoring messages and offsets.
+bool matches(const std::vector<StreamDiagnostic>& diagnostics, const std::vector<Expected>& expected) {
+    if (diagnostics.size() != expected.size())
+        return false;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        const auto& d = diagnostics[i];
+        const auto& e = expected[i];
+        if (d.stream != e.stream || d.attribute != e.attribute || d.code != e.code || d.line != e.line)
+            return false;
+    }
+    return true;
+}
+
+const std::vector<Expected> EXPECTED{
+    {"orphan", "output_interval", StreamErrorCode::missing_stream, 4},
+    {"loop_a", "output_interval", StreamErrorCode::cyclic_reference, 5},
+    {"loop_b", "output_interval", StreamErrorCode::cyclic_reference, 6},
+    {"garbled", "output_interval", StreamErrorCode::malformed_interval, 7},
+    {"misspelled", "clobber_mode", StreamErrorCode::unknown_keyword, 9},
+    {"anonymous_var", "var", StreamErrorCode::unnamed_member, 10},
+};
+
+const LoadOptions STRICT{.keywords = KeywordParsing::strict};
+
+} // namespace
+
+struct LoadDiagnosticsFixture {
+    pugi::xml_document doc;
+
+    LoadDiagnosticsFixture() { doc.load_string(STREAMS_XML); }
+
+    [[nodiscard]] PugiXmlViewAdapter root() const { return PugiXmlViewAdapter{doc.child("streams")}; }
+};
+
+void test_load_diagnostics() {
+    using namespace boost::ut::bdd;
+    "collecting load diagnostics"_test = [] {
+        given("a document with several invalid streams") = [] {
+            const LoadDiagnosticsFixture fixture;
+            StreamSet<PugiXmlViewAdapter> streams;
+            auto diagnostics = streams.load_valid_from_xml(fixture.root(), STRICT);
+            locate_diagnostics(diagnostics, STREAMS_XML);
+
+            then("every invalid stream should be reported once, in load order") = [&] {
+                expect(matches(diagnostics, EXPECTED));
+                expect(eq(diagnostics[0].message, "Referenced stream 'missing' not found"_s));
+                expect(diagnostics[0].offset.has_value());
+            };
+
+            then("the valid streams should still be loaded") = [&] {
+                expect(streams.size() == 3_ul);
+                expect(streams.contains("restart"));
+                expect(streams.find("diagnostics")->get_output_interval() == "6:00:00");
+                expect(!streams.contains("orphan"));
+            };
+
+            then("the throwing load should fail with the first diagnostic") = [&] {
+                StreamSet<PugiXmlViewAdapter> thrown;
+                std::string message;
+                try {
+                    thrown.load_from_xml(fixture.root(), STRICT);
+                } catch (const StreamIntervalError& e) {
+                    message = e.what();
+                }
+                expect(eq(message, diagnostics[0].message));
+            };
+        };
+
+        given("a permissive load of the same document") = [] {
+            const LoadDiagnosticsFixture fixture;
+            StreamSet<PugiXmlViewAdapter> streams;
+            const auto diagnostics = streams.load_valid_from_xml(fixture.root());
+
+            then("the misspelled keyword should not be reported") = [&] {
+                expect(diagnostics.size() == 5_ul);
+                expect(streams.find("misspelled")->get_clobber_mode() == 1_i);
+            };
+        };
+
+        given("a table-backed load") = [] {
+            const StreamTable table{STREAMS_XML};
+            StreamSet<StreamTable::Node> streams;
+            auto diagnostics = streams.load_valid_from_xml(table.root(), STRICT);
+            locate_diagnostics(diagnostics, STREAMS_XML);
+
+            then("offsets should point at the failing element names") = [&] {
+                expect(matches(diagnostics, EXPECTED));
+                const std::string_view xml{STREAMS_XML};
+                expect(xml.substr(*diagnostics[3].offset).starts_with("stream name=\"garbled\""));
+            };
+        };
+
+        given("an owning adapter") = [] {
+            const LoadDiagnosticsFixture fixture;
+            StreamSet<PugiXmlAdapter> streams;
+            auto diagnostics = streams.load_valid_from_xml(PugiXmlAdapter{fixture.doc.child("streams")}, STRICT);
+            locate_diagnostics(diagnostics, STREAMS_XML);
+
+            then("the same diagnostics should be reported") = [&] {
+                expect(matches(diagnostics, EXPECTED));
+            };
+        };
+    };
+
+    "non-throwing resolution"_test = [] {
+        given("a resolver over invalid references") = [] {
+            const LoadDiagnosticsFixture fixture;
+            const StreamIndex<PugiXmlViewAdapter> index{fixture.root()};
+            const IntervalResolver<PugiXmlViewAdapter> resolver{index, {.max_depth = 1}};
+
+            then("errors should be returned with their codes") = [&] {
+                const auto bad_attr = resolver.try_resolve("stream:history:name", "output_interval", "x");
+                const auto self     = resolver.try_resolve("stream:x:output_interval", "output_interval", "x");
+                const auto cycle    = resolver.try_resolve("stream:loop_a:output_interval", "output_interval", "x");
+                expect(bad_attr.error().code == StreamErrorCode::invalid_reference_attribute);
+                expect(self.error().code == StreamErrorCode::self_reference);
+                expect(cycle.error().code == StreamErrorCode::reference_too_deep);
+                expect(*resolver.try_resolve("stream:history:output_interval", "input_interval", "x") == "6:00:00");
+            };
+        };
+
+        given("an attribute name that does not outlive the call") = [] {
+            const LoadDiagnosticsFixture fixture;
+            const StreamIndex<PugiXmlViewAdapter> index{fixture.root()};
+            std::string out;
+            const auto parsed = try_parse_interval_into(out, "stream:missing:output_interval",
+                                                        std::string{"output_interval"}, "x", index);
+
+            then("the error should own its copy of the name") = [&] {
+                expect(parsed.error().code == StreamErrorCode::missing_stream);
+                expect(eq(parsed.error().attribute, "output_interval"_s));
+            };
+        };
+
+        given("diagnostics without offsets") = [] {
+            std::vector<StreamDiagnostic> diagnostics(2);
+            diagnostics[0].offset = 4;
+            locate_diagnostics(diagnostics, "a\nb\nc");
+
+            then("only those with offsets should get a line") = [&] {
+                expect(diagnostics[0].line == std::optional<std::size_t>{3});
+                expect(!diagnostics[1].line.has_value());
+                expect(to_string(StreamErrorCode::unnamed_member) == "unnamed_member");
+            };
+        };
+    };
+}
+
+int main() {
+    test_load_diagnostics();
+}
@@ -0,0 +1,105 @@
+#include <ut.hpp>
+#include <filesystem>
+#include <fstream>
+#include "stream_set.hpp"
+#include "streams_file.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+/// Writes `contents` to a fresh file in the temp directory and removes it on destruction.
+struct TempStreamsFile {
+    std::string path;
+
+    explicit TempStreamsFile(std::string_view contents) {
+        static int counter = 0;
+        path = (std::filesystem::temp_directory_path() /
+                std::format("xml_stream_parser_{}_{}.xml", ::getpid(), counter++)).string();
+        std::ofstream{path, std::ios::binary} << contents;
+    }
+
+    ~TempStreamsFile() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+} // namespace
+
+void test_load_streams_file() {
+    using namespace boost::ut::bdd;
+    "load_streams_file behavior"_test = [] {
+        given("a well-formed streams.xml on disk") = [] {
+            const TempStreamsFile tmp{R"(<?xml version="1.0"?>
+                <streams>
+                    <immutable_stream name="restart" type="input output" output_interval="1_00:00:00"/>
+                    <stream name="history" type="output" filename_template="out/history.$Y.nc"
+                            output_interval="stream:restart:output_interval"/>
+                </streams>
+            )"};
+
+            when("it is mapped and parsed in place") = [&] {
+                const auto file = load_streams_file(tmp.path);
+
+                then("the owning adapter should load every stream") = [&] {
+                    StreamSet<PugiXmlAdapter> set;
+                    set.load_from_xml(file.root());
+                    expect(set.size() == 2_ul);
+                    expect(eq(set.find("history")->get_filename_interval(), "1_00:00:00"_s));
+                };
+
+                then("the view adapter should see the same attributes") = [&] {
+                    const auto history = *file.root_view().children("stream").begin();
+                    expect(history.get_attribute("filename_template") == "out/history.$Y.nc");
+                };
+            };
+
+            when("the file object is moved") = [&] {
+                auto file = load_streams_file(tmp.path);
+                const auto moved = std::move(file);
+
+                then("adapters from the new owner should remain valid") = [&] {
+                    StreamSet<PugiXmlViewAdapter> set;
+                    set.load_from_xml(moved.root_view());
+                    expect(set.size() == 2_ul);
+                };
+
+                then("the moved-from object should have an empty root") = [&] {
+                    StreamSet<PugiXmlAdapter> set;
+                    set.load_from_xml(file.root());
+                    expect(set.empty());
+                };
+            };
+        };
+
+        given("files that cannot be loaded") = [] {
+            then("a missing file should throw a runtime_error") = [] {
+                expect(throws<std::runtime_error>([] {
+                    (void)load_streams_file("/nonexistent/streams.xml");
+                }));
+            };
+
+            then("an empty file should throw a runtime_error") = [] {
+                const TempStreamsFile tmp{""};
+                expect(throws<std::runtime_error>([&] { (void)load_streams_file(tmp.path); }));
+            };
+
+            then("malformed XML should throw a runtime_error") = [] {
+                const TempStreamsFile tmp{"<streams><stream name=\"a\"></streams>"};
+                expect(throws<std::runtime_error>([&] { (void)load_streams_file(tmp.path); }));
+            };
+
+            then("a document without a <streams> element should throw a runtime_error") = [] {
+                const TempStreamsFile tmp{"<config/>"};
+                expect(throws<std::runtime_error>([&] { (void)load_streams_file(tmp.path); }));
+            };
+        };
+    };
+}
+
+int main() {
+    test_load_streams_file();
+}
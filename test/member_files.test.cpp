@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <format>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ut.hpp>
+#include "member_files.hpp"
+#include "mock_xml_file_system.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+constexpr auto STREAMS_XML = R"(
+    <streams>
+        <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00">
+            <file name="restart_vars.txt"/>
+        </immutable_stream>
+        <stream name="history" type="output" output_interval="6:00:00">
+            <file name="stream_list.output"/>
+            <var name="u"/>
+        </stream>
+        <stream name="diagnostics" type="output" output_interval="6:00:00">
+            <file name="stream_list.output"/>
+            <file name="restart_vars.txt"/>
+        </stream>
+    </streams>
+)";
+
+} // namespace
+
+struct MemberFilesFixture {
+    pugi::xml_document doc;
+    StreamSet<PugiXmlViewAdapter> streams;
+    test::RecordingFileSystem fs;
+
+    MemberFilesFixture() {
+        doc.load_string(STREAMS_XML);
+        streams.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+        fs.files["run/stream_list.output"] = "theta\r\nrho\n\n  w  \n";
+        fs.files["run/restart_vars.txt"]   = "xtime\nu";
+    }
+};
+
+void test_member_files() {
+    using namespace boost::ut::bdd;
+    "member line splitting"_test = [] {
+        given("text with blank lines, padding and CRLF endings") = [] {
+            const std::string_view text = "  a \r\n\r\n\tb\n c d \n\n";
+            const auto names = xml_stream_parser::detail::split_member_lines(text);
+
+            then("names should be trimmed views of the text") = [&] {
+                expect(names == std::vector<std::string_view>{"a", "b", "c d"});
+                expect(names[0].data() == text.data() + 2);
+            };
+        };
+
+        given("empty and unterminated text") = [] {
+            then("the lines should be split all the same") = [] {
+                expect(xml_stream_parser::detail::split_member_lines("").empty());
+                expect(xml_stream_parser::detail::split_member_lines("\n \n").empty());
+                expect(xml_stream_parser::detail::split_member_lines("x") == std::vector<std::string_view>{"x"});
+            };
+        };
+    };
+
+    "member file loading"_test = [] {
+        given("streams sharing <file> includes") = [] {
+            MemberFilesFixture fixture;
+
+            then("the includes should be known without reading anything") = [&] {
+                expect(member_file_names(fixture.streams)
+                       == std::vector<std::string>{"restart_vars.txt", "stream_list.output"});
+                expect(fixture.fs.total_calls() == 0_i);
+            };
+
+            when("the set's files are loaded") = [&] {
+                const auto files = load_member_files(fixture.fs, fixture.streams, "run");
+
+                then("each file should be read exactly once") = [&] {
+                    expect(files.size() == 2_ul);
+                    expect(fixture.fs.read_calls == std::map<std::string, int>{
+                        {"run/restart_vars.txt", 1}, {"run/stream_list.output", 1}});
+                };
+
+                then("the names should be split from the file text") = [&] {
+                    expect(files("stream_list.output") == std::vector<std::string_view>{"theta", "rho", "w"});
+                    expect(files("restart_vars.txt") == std::vector<std::string_view>{"xtime", "u"});
+                    expect(throws<std::runtime_error>([&] { (void)files("other.txt"); }));
+                };
+
+                then("streams should expand against the loaded files") = [&] {
+                    const auto expanded = fixture.streams.find("diagnostics")->get_members().expand_files(files);
+                    std::vector<std::string_view> names;
+                    for (const auto member : expanded)
+                        names.push_back(member.name);
+                    expect(names == std::vector<std::string_view>{"theta", "rho", "w", "xtime", "u"});
+                    expect(fixture.fs.read_calls.size() == 2_ul);
+                };
+
+                then("the loaded files should survive being moved") = [&] {
+                    auto loaded = load_member_files(fixture.fs, fixture.streams, "run");
+                    const MemberFiles target = std::move(loaded);
+                    expect(target("stream_list.output")[2] == "w");
+                };
+            };
+        };
+
+        given("an include that cannot be read") = [] {
+            MemberFilesFixture fixture;
+            fixture.fs.files.erase("run/stream_list.output");
+
+            then("loading should name the missing file") = [&] {
+                std::string message;
+                try {
+                    (void)load_member_files(fixture.fs, fixture.streams, "run");
+                } catch (const std::runtime_error& e) {
+                    message = e.what();
+                }
+                expect(eq(message, "Failed to read member file 'run/stream_list.output'"_s));
+            };
+        };
+
+        given("many includes read by several threads") = [] {
+            test::RecordingFileSystem fs;
+            std::vector<std::string> names;
+            for (int i = 0; i < 64; ++i) {
+                names.push_back(std::format("list_{}.txt", i));
+                fs.files[names.back()] = std::format("a{}\nb{}\n", i, i);
+            }
+            names.push_back("list_0.txt");
+            const auto files = load_member_files(fs, names, {}, 4);
+
+            then("every file should be read once and split correctly") = [&] {
+                expect(files.size() == 64_ul);
+                expect(fs.total_calls() == 64_i);
+                bool all_split = true;
+                for (int i = 0; i < 64; ++i) {
+                    const std::vector<std::string> expected{std::format("a{}", i), std::format("b{}", i)};
+                    all_split = all_split && std::ranges::equal(files(std::format("list_{}.txt", i)), expected);
+                }
+                expect(all_split);
+            };
+        };
+    };
+}
+
+int main() {
+    test_member_files();
+}
@@ -2,6 +2,12 @@
 #ifndef XML_STREAM_PARSER_MOCK_XML_FILE_SYSTEM_HPP
 #define XML_STREAM_PARSER_MOCK_XML_FILE_SYSTEM_HPP
 
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+
 #include "filesystem.hpp"
 
 namespace xml_stream_parser::test {
@@ -25,6 +31,67 @@ public:
     }
 };
 
+/**
+ * Filesystem mock that records every call per path. Directories in
+ * `existing` exist; `create_directories` adds a path and its ancestors
+ * unless the path is in `uncreatable`; paths in `read_only` are not writable;
+ * `files` maps readable file paths to their contents.
+ * Calls may come from several threads.
+ */
+class RecordingFileSystem final : public IXmlFileSystem {
+public:
+    std::set<std::string> existing;
+    std::set<std::string> uncreatable;
+    std::set<std::string> read_only;
+    std::map<std::string, std::string> files;
+
+    mutable std::map<std::string, int> exists_calls;
+    mutable std::map<std::string, int> can_write_calls;
+    std::map<std::string, int> create_calls;
+    mutable std::map<std::string, int> read_calls;
+
+    [[nodiscard]] bool exists(const std::string& path) const noexcept override {
+        const std::scoped_lock lock{m_mutex};
+        ++exists_calls[path];
+        return existing.contains(path);
+    }
+
+    bool create_directories(const std::string& path) noexcept override {
+        const std::scoped_lock lock{m_mutex};
+        ++create_calls[path];
+        if (uncreatable.contains(path))
+            return false;
+        for (fs::path p{path}; !p.empty() && p != p.parent_path(); p = p.parent_path())
+            existing.insert(p.string());
+        return true;
+    }
+
+    [[nodiscard]] bool can_write(const std::string& path) const noexcept override {
+        const std::scoped_lock lock{m_mutex};
+        ++can_write_calls[path];
+        return !read_only.contains(path);
+    }
+
+    [[nodiscard]] std::optional<std::string> read_file(const std::string& path) const override {
+        const std::scoped_lock lock{m_mutex};
+        ++read_calls[path];
+        if (const auto it = files.find(path); it != files.end())
+            return it->second;
+        return std::nullopt;
+    }
+
+    [[nodiscard]] int total_calls() const {
+        int total = 0;
+        for (const auto& calls : {exists_calls, can_write_calls, create_calls, read_calls})
+            for (const auto& [path, count] : calls)
+                total += count;
+        return total;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+};
+
 } // namespace xml_stream_parser::test
 
 #endif // XML_STREAM_PARSER_MOCK_XML_FILE_SYSTEM_HPP
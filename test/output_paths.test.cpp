@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <ut.hpp>
+#include "mock_xml_file_system.hpp"
+#include "output_paths.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+using namespace xml_stream_parser::test;
+
+struct OutputPathsFixture {
+    RecordingFileSystem fs;
+    std::vector<OutputPath> paths;
+
+    OutputPathsFixture() {
+        for (int i = 0; i < 100; ++i)
+            paths.push_back({"history", 2, "/scratch/run/output/history.$Y-$M-$D.nc"});
+        paths.push_back({"restart", 3, "/scratch/run/output/"
+                                       "restart.$Y-$M-$D.nc"});
+        paths.push_back({"diagnostics", 2, "/scratch/run/output/./diag.nc"});
+        paths.push_back({"surface", 2, "/scratch/run/output/surface/sfc.nc"});
+        paths.push_back({"forcing", 1, "/scratch/run/input/forcing.nc"});
+        paths.push_back({"local", 2, "local.nc"});
+    }
+};
+
+void test_output_paths() {
+    using namespace boost::ut::bdd;
+    "batched output path preparation"_test = [] {
+        given("many output streams sharing a few directories") = [] {
+            OutputPathsFixture fixture;
+            const OutputDirectoryPlan plan{fixture.paths};
+
+            then("each distinct output directory should be planned once, deepest first") = [&] {
+                expect(plan.size() == 2_ul);
+                expect(eq(plan.directories()[0].path, "/scratch/run/output/surface"_s));
+                expect(eq(plan.directories()[1].path, "/scratch/run/output"_s));
+                expect(plan.directories()[1].streams.size() == 102_ul);
+            };
+
+            when("none of the directories exist yet") = [&] {
+                const auto errors = prepare_output_paths(fixture.fs, plan);
+
+                then("the deepest directory should be created and its ancestors not checked again") = [&] {
+                    expect(errors.empty());
+                    expect(fixture.fs.create_calls.size() == 1_ul);
+                    expect(fixture.fs.create_calls["/scratch/run/output/surface"] == 1_i);
+                    expect(!fixture.fs.exists_calls.contains("/scratch/run/output"));
+                };
+
+                then("each directory should be checked for writability once") = [&] {
+                    expect(fixture.fs.can_write_calls["/scratch/run/output"] == 1_i);
+                    expect(fixture.fs.can_write_calls["/scratch/run/output/surface"] == 1_i);
+                    expect(fixture.fs.total_calls() == 4_i);
+                };
+            };
+        };
+
+        given("a directory that cannot be created and one that is read-only") = [] {
+            OutputPathsFixture fixture;
+            fixture.fs.uncreatable.insert("/scratch/run/output/surface");
+            fixture.fs.existing.insert("/scratch/run/output");
+            fixture.fs.read_only.insert("/scratch/run/output");
+
+            const auto errors = prepare_output_paths(fixture.fs, std::span<const OutputPath>{fixture.paths});
+
+            then("every stream in a failing directory should get its own error") = [&] {
+                expect(errors.size() == 103_ul);
+                expect(eq(errors.front().stream_id, "surface"_s));
+                expect(eq(errors.front().message,
+                          "Failed to create directory '/scratch/run/output/surface'"_s));
+                expect(eq(errors.back().stream_id, "diagnostics"_s));
+                expect(eq(errors.back().message, "Directory '/scratch/run/output' is not writable"_s));
+            };
+
+            then("a failed creation should not mark its ancestors as present") = [&] {
+                expect(fixture.fs.exists_calls["/scratch/run/output"] == 1_i);
+            };
+        };
+
+        given("a loaded stream set") = [] {
+            pugi::xml_document doc;
+            doc.load_string(R"(
+                <streams>
+                    <stream name="history" type="output" filename_template="out/history.nc" output_interval="6:00:00"/>
+                    <stream name="diagnostics" type="output" filename_template="out/diag.nc" output_interval="6:00:00"/>
+                    <stream name="forcing" type="input" filename_template="in/forcing.nc" input_interval="6:00:00"/>
+                </streams>
+            )");
+            StreamSet<PugiXmlAdapter> streams;
+            streams.load_from_xml(PugiXmlAdapter{doc.child("streams")});
+
+            RecordingFileSystem fs;
+            const auto errors = prepare_output_paths(fs, streams);
+
+            then("only the shared output directory should be prepared") = [&] {
+                expect(errors.empty());
+                expect(fs.create_calls.size() == 1_ul);
+                expect(fs.create_calls["out"] == 1_i);
+                expect(!fs.can_write_calls.contains("in"));
+            };
+
+            then("planning from the XML should find the same directories before loading") = [&] {
+                const auto plan = plan_output_directories(PugiXmlAdapter{doc.child("streams")});
+                expect(plan.size() == 1_ul);
+                expect(eq(plan.directories()[0].path, "out"_s));
+                expect(plan.directories()[0].streams.size() == 2_ul);
+            };
+        };
+    };
+
+    "asynchronous output path preparation"_test = [] {
+        given("nested and unrelated output directories") = [] {
+            std::vector<std::string> templates{"/run/a/x/y/f.nc", "/run/a/x/f.nc", "/run/b/f.nc"};
+            for (int i = 0; i < 40; ++i)
+                templates.push_back("/run/members/" + std::to_string(i) + "/f.nc");
+
+            std::vector<OutputPath> paths;
+            for (const auto& t : templates)
+                paths.push_back({t, 2, t});
+            const OutputDirectoryPlan plan{paths};
+
+            then("ancestors and descendants should share a group") = [&] {
+                expect(plan.groups().size() == 42_ul);
+                expect(std::ranges::any_of(plan.groups(), [](const auto& g) { return g.size() == 2; }));
+            };
+
+            when("they are prepared concurrently") = [&] {
+                RecordingFileSystem fs;
+                auto pending = prepare_output_paths_async(fs, plan, 4);
+                const auto errors = pending.get();
+
+                then("each directory should be created once and its nested ancestor not at all") = [&] {
+                    expect(errors.empty());
+                    expect(fs.create_calls.size() == 42_ul);
+                    expect(!fs.create_calls.contains("/run/a/x"));
+                    expect(!fs.exists_calls.contains("/run/a/x"));
+                    expect(fs.can_write_calls.size() == 43_ul);
+                };
+            };
+
+            when("some directories fail") = [&] {
+                RecordingFileSystem serial_fs;
+                RecordingFileSystem async_fs;
+                for (auto* fs : {&serial_fs, &async_fs}) {
+                    fs->uncreatable.insert("/run/a/x/y");
+                    fs->read_only.insert("/run/members/7");
+                }
+                const auto serial = prepare_output_paths(serial_fs, plan);
+                const auto async  = prepare_output_paths_async(async_fs, plan, 8).get();
+
+                then("the errors should match a serial run, in the same order") = [&] {
+                    expect(async.size() == 2_ul);
+                    expect(serial.size() == async.size());
+                    for (std::size_t i = 0; i < std::min(serial.size(), async.size()); ++i) {
+                        expect(eq(serial[i].stream_id, async[i].stream_id));
+                        expect(eq(serial[i].message, async[i].message));
+                    }
+                };
+            };
+        };
+    };
+}
+
+int main() {
+    test_output_paths();
+}
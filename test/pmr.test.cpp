@@ -0,0 +1,176 @@
+#include <ut.hpp>
+#include <memory_resource>
+#include "stream_serialization.hpp"
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+/// Forwards to an upstream resource and counts what passes through.
+class CountingResource final : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : m_upstream{upstream} {}
+
+    std::size_t allocations{0};
+    std::size_t bytes{0};
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override {
+        ++allocations;
+        bytes += size;
+        return m_upstream->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t size, std::size_t alignment) override {
+        m_upstream->deallocate(p, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* m_upstream;
+};
+
+} // namespace
+
+struct PmrFixture {
+    pugi::xml_document doc;
+
+    PmrFixture() {
+        doc.load_string(R"(
+            <streams>
+                <immutable_stream name="restart_with_a_long_name" type="input output"
+                                  filename_template="restart/restart.$Y-$M-$D_$h.$m.$s.nc"
+                                  input_interval="initial_only" output_interval="1_00:00:00"
+                                  reference_time="0001-01-01_00:00:00"/>
+                <stream name="history_with_a_long_name" type="output"
+                        filename_template="history/history.$Y-$M-$D_$h.$m.$s.nc"
+                        output_interval="stream:restart_with_a_long_name:output_interval"/>
+            </streams>
+        )");
+    }
+
+    [[nodiscard]] PugiXmlAdapter root() const { return PugiXmlAdapter{doc.child("streams")}; }
+};
+
+template<typename A, typename B>
+bool same_values(const A& a, const B& b) {
+    return a.get_stream_id() == b.get_stream_id() &&
+           a.get_filename_template() == b.get_filename_template() &&
+           a.get_filename_interval() == b.get_filename_interval() &&
+           a.get_input_interval() == b.get_input_interval() &&
+           a.get_output_interval() == b.get_output_interval() &&
+           a.get_reference_time() == b.get_reference_time() &&
+           a.get_record_interval() == b.get_record_interval() &&
+           a.get_type() == b.get_type() &&
+           a.get_immutable() == b.get_immutable();
+}
+
+void test_pmr() {
+    using namespace boost::ut::bdd;
+    "polymorphic allocator support"_test = [] {
+        given("a stream set loaded into a monotonic arena") = [] {
+            const PmrFixture fixture;
+            CountingResource counter{std::pmr::new_delete_resource()};
+            std::pmr::monotonic_buffer_resource arena{&counter};
+
+            pmr::StreamSet<PugiXmlAdapter> streams{&arena};
+            streams.load_from_xml(fixture.root());
+
+            StreamSet<PugiXmlAdapter> reference;
+            reference.load_from_xml(fixture.root());
+
+            then("the streams should match a default-allocator load") = [&] {
+                expect(streams.size() == reference.size());
+                for (std::size_t i = 0; i < streams.size(); ++i)
+                    expect(same_values(streams.streams()[i], reference.streams()[i]));
+            };
+
+            then("every stream should allocate from the arena") = [&] {
+                expect(counter.allocations > 0_ul);
+                for (const auto& stream : streams) {
+                    expect(stream.get_allocator().resource() == &arena);
+                    expect(stream.get_stream_id().get_allocator().resource() == &arena);
+                    expect(stream.get_compiled_filename_template().get_allocator().resource() == &arena);
+                }
+            };
+
+            then("lookup by name should work on arena-allocated keys") = [&] {
+                const auto* history = streams.find("history_with_a_long_name");
+                expect(fatal(history != nullptr));
+                expect(eq(std::string(history->get_filename_interval()), "1_00:00:00"_s));
+            };
+
+            when("the arena is released") = [&] {
+                streams = pmr::StreamSet<PugiXmlAdapter>{&arena};
+                const auto before = counter.allocations;
+                arena.release();
+
+                then("nothing further should be requested upstream") = [&] {
+                    expect(counter.allocations == before);
+                };
+            };
+        };
+
+        given("the pmr parse helpers") = [] {
+            const PmrFixture fixture;
+            std::pmr::monotonic_buffer_resource arena;
+            const StreamIndex<PugiXmlAdapter> index{fixture.root()};
+
+            then("parse_fields should allocate keys and values from the resource") = [&] {
+                const auto fields = pmr::parse_fields(*index.find("restart_with_a_long_name"), &arena);
+                expect(fields.get_allocator().resource() == &arena);
+                expect(fields.at("reference_time") == "0001-01-01_00:00:00");
+                expect(fields.at("reference_time").get_allocator().resource() == &arena);
+            };
+
+            then("parse_interval should resolve references into the resource") = [&] {
+                const auto interval = pmr::parse_interval("stream:restart_with_a_long_name:output_interval",
+                                                          "output_interval", "history_with_a_long_name",
+                                                          index, &arena);
+                expect(interval == "1_00:00:00");
+                expect(interval.get_allocator().resource() == &arena);
+            };
+
+            then("parse_filename_interval should agree with the default version") = [&] {
+                const auto pmr_result = pmr::parse_filename_interval(
+                    "output", "", "stream:restart_with_a_long_name:output_interval", "",
+                    "history_with_a_long_name", index, &arena);
+                const auto std_result = parse_filename_interval(
+                    "output", "", "stream:restart_with_a_long_name:output_interval", "",
+                    "history_with_a_long_name", index);
+                expect(eq(std::string(pmr_result), std_result));
+                expect(pmr_result.get_allocator().resource() == &arena);
+            };
+
+            then("a pmr filename template should expand like the default one") = [&] {
+                const pmr::FilenameTemplate tmpl{"out/$Y/$M.nc", &arena};
+                expect(eq(tmpl.expand(TemplateTime{.year = 7, .month = 2}), "out/0007/02.nc"_s));
+            };
+        };
+
+        given("a serialized stream set") = [] {
+            const PmrFixture fixture;
+            StreamSet<PugiXmlAdapter> reference;
+            reference.load_from_xml(fixture.root());
+            const auto buffer = serialize(reference);
+
+            then("it should deserialize into an arena") = [&] {
+                std::pmr::monotonic_buffer_resource arena;
+                const auto restored = deserialize<PugiXmlAdapter>(
+                    buffer, std::pmr::polymorphic_allocator<char>{&arena});
+                expect(restored.get_allocator().resource() == &arena);
+                expect(same_values(*restored.find("history_with_a_long_name"),
+                                   *reference.find("history_with_a_long_name")));
+            };
+        };
+    };
+}
+
+int main() {
+    test_pmr();
+}
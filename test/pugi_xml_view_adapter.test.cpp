@@ -0,0 +1,83 @@
+#include <ut.hpp>
+#include "pugi_xml_view_adapter.hpp"
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+static_assert(XmlNodeView<PugiXmlViewAdapter>);
+static_assert(!XmlNode<PugiXmlViewAdapter>);
+static_assert(XmlNodeLike<PugiXmlViewAdapter> && XmlNodeLike<PugiXmlAdapter>);
+
+struct XmlViewAdapterFixture {
+    pugi::xml_document doc;
+    PugiXmlViewAdapter streams{pugi::xml_node{}};
+
+    XmlViewAdapterFixture() {
+        doc.load_string(R"(
+            <streams>
+                <immutable_stream name="input" type="input" input_interval="initial_only" io_type="pnetcdf,cdf5"/>
+                <stream name="history" type="output" output_interval="6:00:00" precision="single"/>
+                <stream name="diagnostics" type="output" output_interval="stream:history:output_interval"/>
+            </streams>
+        )");
+        streams = PugiXmlViewAdapter{doc.child("streams")};
+    }
+};
+
+void test_pugi_xml_view_adapter() {
+    using namespace boost::ut::bdd;
+    "pugi xml view adapter"_test = [] {
+        given("a streams document wrapped in a view adapter") = [] {
+            const XmlViewAdapterFixture fixture;
+
+            when("attributes are queried") = [&] {
+                const auto history = *fixture.streams.children("stream").begin();
+
+                then("present attributes should be returned as views into the document") = [&] {
+                    expect(history.get_attribute("output_interval") == "6:00:00");
+                    expect(history.has_attribute("precision"));
+                };
+
+                then("missing attributes should yield an empty view") = [&] {
+                    expect(history.get_attribute("io_type").empty());
+                    expect(!history.has_attribute("io_type"));
+                };
+
+                then("all attributes should be visited in document order") = [&] {
+                    std::size_t count = 0;
+                    for (const auto& [key, value] : history.get_attributes()) {
+                        expect(!key.empty());
+                        ++count;
+                    }
+                    expect(count == 4_ul);
+                };
+            };
+
+            when("children are iterated lazily") = [&] {
+                then("only elements with the requested tag should be visited") = [&] {
+                    expect(std::ranges::distance(fixture.streams.children("stream")) == 2_l);
+                    expect(std::ranges::distance(fixture.streams.children("immutable_stream")) == 1_l);
+                    expect(std::ranges::distance(fixture.streams.children("var")) == 0_l);
+                };
+            };
+
+            when("streams are loaded through the view adapter") = [&] {
+                StreamSet<PugiXmlViewAdapter> set;
+                set.load_from_xml(fixture.streams);
+
+                then("they should match the values parsed through the owning adapter") = [&] {
+                    expect(set.size() == 3_ul);
+                    expect(set.find("input")->get_iotype() == 1_i);
+                    expect(set.find("history")->get_precision() == 4_i);
+                    expect(eq(set.find("diagnostics")->get_filename_interval(), "6:00:00"_s));
+                };
+            };
+        };
+    };
+}
+
+int main() {
+    test_pugi_xml_view_adapter();
+}
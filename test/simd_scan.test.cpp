@@ -0,0 +1,222 @@
+#include <cstddef>
+#include <format>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ut.hpp>
+#include "simd_scan.hpp"
+#include "stream_serialization.hpp"
+#include "stream_table.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+/// Every level this CPU supports, scalar first.
+std::vector<SimdLevel> available_levels() {
+    std::vector<SimdLevel> levels;
+    for (auto level : {SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2})
+        if (level <= supported_simd_level())
+            levels.push_back(level);
+    return levels;
+}
+
+/// Restores the detected level when a test is done switching levels.
+struct SimdLevelGuard {
+    ~SimdLevelGuard() { set_simd_level(supported_simd_level()); }
+};
+
+/// Everything the pull parser reports for a document, or the error it threw.
+std::string tokenize(std::string_view xml) {
+    std::string trace;
+    try {
+        XmlPullParser parser{xml};
+        for (auto event = parser.next(); event != XmlPullParser::Event::end_document; event = parser.next()) {
+            trace += std::format("{}{}@{}", static_cast<int>(event), parser.name(), parser.offset());
+            for (const auto& attr : parser.attributes())
+                trace += std::format(" {}={}", attr.name, attr.value);
+            trace += '\n';
+        }
+    } catch (const std::runtime_error& e) {
+        trace += e.what();
+    }
+    return trace;
+}
+
+/// The streams a `StreamTable` keeps for a document, or the error it threw.
+std::string tabulate(std::string_view xml) {
+    std::string dump;
+    try {
+        const StreamTable table{xml};
+        for (const auto tag : {"immutable_stream", "stream"}) {
+            for (const auto& node : table.root().children(tag)) {
+                dump += node.name();
+                for (const auto& [name, value] : node.get_attributes())
+                    dump += std::format(" {}={}", name, value);
+                dump += '\n';
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        dump += e.what();
+    }
+    return dump;
+}
+
+/**
+ * A random but valid streams document: varying layout, quoting, comments,
+ * variable lists, `stream:` references to earlier literal intervals, and
+ * attribute values holding entities, tabs and line breaks.
+ */
+std::string generate_streams(std::mt19937& rng) {
+    auto pick = [&](int n) { return static_cast<int>(rng() % static_cast<unsigned>(n)); };
+    auto space = [&] {
+        static constexpr std::string_view options[] = {" ", "  ", "\n    ", "\t", "\r\n  "};
+        return std::string(options[pick(5)]);
+    };
+    // Decoded by the backends: entities, character references, and raw
+    // whitespace that attribute normalization turns into spaces.
+    auto encoded = [&] {
+        static constexpr std::string_view options[] = {
+            "", "", "", "&amp;x", "&lt;&gt;", "&quot;&apos;", "&#10;", "&#x9;", "&#13;&#10;",
+            "\r\n", "\t", "\n\r", "a\r\r\nb", "\r"};
+        return std::string(options[pick(14)]);
+    };
+    auto attr = [&](std::string_view name, std::string_view value) {
+        const char quote = pick(2) ? '"' : '\'';
+        return std::format("{}{}{}={}{}{}{}", space(), name, pick(4) ? "" : " ", pick(4) ? "" : " ",
+                           quote, value, quote);
+    };
+
+    std::string xml = pick(2) ? "<?xml version=\"1.0\"?>\n" : "";
+    xml += "<streams>";
+    std::vector<std::string> literal_targets;
+    const int streams = 1 + pick(20);
+    for (int s = 0; s < streams; ++s) {
+        if (pick(4) == 0)
+            xml += "<!-- <stream name=\"commented\"/> -->";
+        const bool immutable = pick(5) == 0;
+        const auto name      = std::format("s{}", s);
+        xml += std::format("\n<{}{}", immutable ? "immutable_stream" : "stream", attr("name", name));
+
+        static constexpr std::string_view types[] = {"input", "output", "input output",
+                                                     "input&#10;output", "input\r\noutput"};
+        xml += attr("type", types[pick(5)]);
+        if (pick(2))
+            xml += attr("filename_template", std::format("out/{}/{}{}.$Y-$M.nc", pick(3), name, encoded()));
+        if (pick(3))
+            xml += attr("precision", pick(2) ? "single" : "double");
+
+        if (!literal_targets.empty() && pick(2)) {
+            xml += attr("output_interval",
+                        std::format("stream:{}:output_interval", literal_targets[pick(static_cast<int>(literal_targets.size()))]));
+        } else {
+            xml += attr("output_interval", std::format("{}:00:00", 1 + pick(24)));
+            literal_targets.push_back(name);
+        }
+
+        const int vars = pick(4) == 0 ? 0 : pick(30);
+        if (vars == 0) {
+            xml += pick(2) ? "/>" : std::format("></{}>", immutable ? "immutable_stream" : "stream");
+            continue;
+        }
+        xml += ">";
+        for (int v = 0; v < vars; ++v)
+            xml += std::format("{}<var{}/>", space(), attr("name", std::format("variable_{}{}", v, encoded())));
+        xml += std::format("\n</{}>", immutable ? "immutable_stream" : "stream");
+    }
+    xml += "\n</streams>\n";
+    return xml;
+}
+
+} // namespace
+
+struct SimdScanFixture {
+    std::mt19937 rng{20240611};
+    SimdLevelGuard guard;
+};
+
+void test_simd_scan() {
+    using namespace boost::ut::bdd;
+    "simd scanning"_test = [] {
+        given("random buffers of XML delimiter and filler bytes") = [] {
+            SimdScanFixture fixture;
+            static constexpr std::string_view alphabet = "<>=\"' \t\n\rab&/";
+
+            then("every level should find the same positions as the scalar scan") = [&] {
+                for (int round = 0; round < 2000; ++round) {
+                    std::string text(fixture.rng() % 100, 'x');
+                    for (auto& c : text)
+                        if (fixture.rng() % 8 == 0)
+                            c = alphabet[fixture.rng() % alphabet.size()];
+                    const auto pos = text.empty() ? 0 : fixture.rng() % (text.size() + 1);
+
+                    set_simd_level(SimdLevel::scalar);
+                    const auto any  = find_any_of<'<', '>', '=', '"'>(text, pos);
+                    const auto none = find_none_of<' ', '\t', '\n', '\r', 'x'>(text, pos);
+                    for (const auto level : available_levels()) {
+                        set_simd_level(level);
+                        expect(find_any_of<'<', '>', '=', '"'>(text, pos) == any);
+                        expect(find_none_of<' ', '\t', '\n', '\r', 'x'>(text, pos) == none);
+                    }
+                }
+            };
+        };
+    };
+
+    "tokenizer equivalence"_test = [] {
+        given("generated streams documents") = [] {
+            SimdScanFixture fixture;
+
+            then("the SIMD-backed table should load the same streams as the pugixml backend") = [&] {
+                for (int round = 0; round < 200; ++round) {
+                    const auto xml = generate_streams(fixture.rng);
+
+                    pugi::xml_document doc;
+                    expect(static_cast<bool>(doc.load_string(xml.c_str()))) << xml;
+                    StreamSet<PugiXmlViewAdapter> reference;
+                    reference.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+                    const auto expected = serialize(reference);
+
+                    for (const auto level : available_levels()) {
+                        set_simd_level(level);
+                        const StreamTable table{xml};
+                        StreamSet<StreamTable::Node> streams;
+                        streams.load_from_xml(table.root());
+                        const bool same = serialize(streams) == expected;
+                        expect(same) << "level" << static_cast<int>(level) << "round" << round;
+                    }
+                }
+            };
+        };
+
+        given("generated documents with random byte corruption") = [] {
+            SimdScanFixture fixture;
+            static constexpr std::string_view noise = "<>=\"'&; /\n!-?[]";
+
+            then("every level should report the same events, tables or errors") = [&] {
+                for (int round = 0; round < 1000; ++round) {
+                    auto xml = generate_streams(fixture.rng);
+                    const auto edits = 1 + fixture.rng() % 4;
+                    for (unsigned e = 0; e < edits; ++e)
+                        xml[fixture.rng() % xml.size()] = noise[fixture.rng() % noise.size()];
+
+                    set_simd_level(SimdLevel::scalar);
+                    const auto events = tokenize(xml);
+                    const auto table  = tabulate(xml);
+                    for (const auto level : available_levels()) {
+                        set_simd_level(level);
+                        expect(tokenize(xml) == events) << "level" << static_cast<int>(level);
+                        expect(tabulate(xml) == table) << "level" << static_cast<int>(level);
+                    }
+                }
+            };
+        };
+    };
+}
+
+int main() {
+    test_simd_scan();
+}
@@ -0,0 +1,81 @@
+#include <ut.hpp>
+#include "stream_attributes.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+static_assert(classify_stream_attribute("filename_interval") == StreamAttribute::filename_interval);
+static_assert(classify_stream_attribute("filename_template") == StreamAttribute::filename_template);
+static_assert(!classify_stream_attribute("filename_templates"));
+static_assert(!classify_stream_attribute(""));
+
+struct XmlStreamAttributesFixture {
+    pugi::xml_document doc;
+    pugi::xml_node stream_node;
+
+    XmlStreamAttributesFixture() {
+        doc.load_string(R"(
+            <streams>
+                <immutable_stream name="restart" type="input output" filename_template="restart.$Y.nc"
+                                  input_interval="initial_only" output_interval="1_00:00:00"
+                                  reference_time="2000-01-01_00:00:00" precision="double"
+                                  io_type="pnetcdf,cdf5" clobber_mode="truncate" packages="restart_pkg"/>
+            </streams>
+        )");
+        stream_node = doc.child("streams").child("immutable_stream");
+    }
+};
+
+void test_stream_attributes() {
+    using namespace boost::ut::bdd;
+    "stream attribute table"_test = [] {
+        given("every known attribute name") = [] {
+            then("each should classify to its own slot") = [] {
+                for (std::size_t i = 0; i < STREAM_ATTRIBUTE_COUNT; ++i)
+                    expect(classify_stream_attribute(STREAM_ATTRIBUTES[i]) == static_cast<StreamAttribute>(i));
+            };
+        };
+
+        given("a stream element with known and unknown attributes") = [] {
+            const XmlStreamAttributesFixture fixture;
+
+            when("it is parsed through the view adapter") = [&] {
+                const auto table = parse_stream_attributes(PugiXmlViewAdapter{fixture.stream_node});
+
+                then("known attributes should land in their slots") = [&] {
+                    expect(table[StreamAttribute::name] == "restart");
+                    expect(table[StreamAttribute::output_interval] == "1_00:00:00");
+                    expect(table[StreamAttribute::clobber_mode] == "truncate");
+                };
+
+                then("absent attributes should read as empty and not be reported present") = [&] {
+                    expect(table[StreamAttribute::record_interval].empty());
+                    expect(!table.contains(StreamAttribute::record_interval));
+                    expect(!table.contains(StreamAttribute::filename_interval));
+                    expect(table.contains(StreamAttribute::precision));
+                };
+
+                then("unknown attributes should go to the overflow list") = [&] {
+                    expect(table.unknown().size() == 1_ul);
+                    expect(table.unknown().front().first == "packages");
+                    expect(table.unknown().front().second == "restart_pkg");
+                };
+            };
+
+            when("it is parsed through the owning adapter") = [&] {
+                const auto table = parse_stream_attributes(PugiXmlAdapter{fixture.stream_node});
+
+                then("it should hold the same values") = [&] {
+                    expect(table[StreamAttribute::filename_template] == "restart.$Y.nc");
+                    expect(table[StreamAttribute::io_type] == "pnetcdf,cdf5");
+                    expect(table.unknown().size() == 1_ul);
+                };
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_attributes();
+}
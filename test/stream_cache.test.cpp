@@ -0,0 +1,212 @@
+#include <ut.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "stream_cache.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+constexpr std::string_view STREAMS_XML = R"(<?xml version="1.0"?>
+<streams>
+    <immutable_stream name="restart" type="input output" filename_template="restart.$Y-$M-$D.nc"
+                      input_interval="initial_only" output_interval="1_00:00:00"
+                      reference_time="0001-01-01_00:00:00" precision="double"/>
+    <stream name="history" type="output" filename_template="out/history.$Y.nc"
+            output_interval="stream:restart:output_interval" io_type="netcdf4"
+            clobber_mode="truncate"/>
+</streams>
+)";
+
+/// A streams.xml file and its cache path in the temp directory, both removed on destruction.
+struct TempCachePair {
+    std::string xml_path;
+    std::string cache_path;
+
+    explicit TempCachePair(std::string_view contents) {
+        static int counter = 0;
+        const auto stem = std::filesystem::temp_directory_path() /
+                          std::format("xml_stream_parser_cache_{}_{}", ::getpid(), counter++);
+        xml_path   = stem.string() + ".xml";
+        cache_path = stem.string() + ".bin";
+        write_xml(contents);
+    }
+
+    void write_xml(std::string_view contents) const {
+        std::ofstream{xml_path, std::ios::binary | std::ios::trunc} << contents;
+    }
+
+    ~TempCachePair() {
+        std::error_code ec;
+        std::filesystem::remove(xml_path, ec);
+        std::filesystem::remove(cache_path, ec);
+    }
+};
+
+} // namespace
+
+void test_stream_cache() {
+    using namespace boost::ut::bdd;
+    "stream cache behavior"_test = [] {
+        given("a streams.xml file without a cache") = [] {
+            const TempCachePair tmp{STREAMS_XML};
+
+            when("it is loaded twice") = [&] {
+                const auto first  = load_or_build(tmp.xml_path, tmp.cache_path);
+                const auto second = load_or_build(tmp.xml_path, tmp.cache_path);
+
+                then("the first load should parse and write the cache") = [&] {
+                    expect(!first.cache_hit);
+                    expect(std::filesystem::exists(tmp.cache_path));
+                };
+
+                then("no temporary file should be left next to the cache") = [&] {
+                    const auto prefix = std::filesystem::path{tmp.cache_path}.filename().string() + ".tmp.";
+                    const auto dir = std::filesystem::path{tmp.cache_path}.parent_path();
+                    expect(std::ranges::none_of(std::filesystem::directory_iterator{dir}, [&](const auto& entry) {
+                        return entry.path().filename().string().starts_with(prefix);
+                    }));
+                };
+
+                then("the second load should come from the cache with identical streams") = [&] {
+                    expect(second.cache_hit);
+                    expect(second.streams.size() == 2_ul);
+                    expect(std::ranges::equal(first.streams, second.streams));
+                    expect(eq(second.streams.find("history")->get_filename_interval(), "1_00:00:00"_s));
+                };
+            };
+
+            when("it is loaded through the owning adapter") = [&] {
+                const auto built  = load_or_build<PugiXmlAdapter>(tmp.xml_path, tmp.cache_path);
+                const auto cached = load_or_build<PugiXmlAdapter>(tmp.xml_path, tmp.cache_path);
+
+                then("the cached streams should match the parsed ones") = [&] {
+                    expect(cached.cache_hit);
+                    expect(std::ranges::equal(built.streams, cached.streams));
+                };
+            };
+        };
+
+        given("a cache that no longer matches its source") = [] {
+            const TempCachePair tmp{STREAMS_XML};
+            (void)load_or_build(tmp.xml_path, tmp.cache_path);
+
+            when("the XML is edited") = [&] {
+                auto edited = std::string{STREAMS_XML};
+                edited.replace(edited.find("1_00:00:00"), 10, "2_00:00:00");
+                tmp.write_xml(edited);
+                const auto result = load_or_build(tmp.xml_path, tmp.cache_path);
+
+                then("the streams should be rebuilt from the new XML") = [&] {
+                    expect(!result.cache_hit);
+                    expect(eq(result.streams.find("history")->get_filename_interval(), "2_00:00:00"_s));
+                };
+            };
+
+            when("the load options change the resolution rules") = [&] {
+                const auto result = load_or_build(tmp.xml_path, tmp.cache_path,
+                                                  LoadOptions{.intervals = {.strict = true}});
+
+                then("the cache should be rebuilt") = [&] {
+                    expect(!result.cache_hit);
+                };
+            };
+        };
+
+        given("a damaged cache file") = [] {
+            const TempCachePair tmp{STREAMS_XML};
+            const auto reference = load_or_build(tmp.xml_path, tmp.cache_path);
+            const auto size = std::filesystem::file_size(tmp.cache_path);
+
+            then("a truncated cache should be rebuilt") = [&] {
+                std::filesystem::resize_file(tmp.cache_path, size / 2);
+                const auto result = load_or_build(tmp.xml_path, tmp.cache_path);
+                expect(!result.cache_hit);
+                expect(std::ranges::equal(reference.streams, result.streams));
+            };
+
+            then("a cache with a bad magic number should be rebuilt") = [&] {
+                {
+                    std::fstream f{tmp.cache_path, std::ios::in | std::ios::out | std::ios::binary};
+                    f.write("NOTCACHE", 8);
+                }
+                const auto result = load_or_build(tmp.xml_path, tmp.cache_path);
+                expect(!result.cache_hit);
+                expect(std::ranges::equal(reference.streams, result.streams));
+            };
+        };
+
+        given("raw cache bytes") = [] {
+            const TempCachePair tmp{STREAMS_XML};
+            const auto reference = load_or_build(tmp.xml_path, tmp.cache_path);
+            const auto bytes = encode_stream_cache(reference.streams, 42);
+
+            then("a view should open only with the matching key") = [&] {
+                expect(StreamCacheView::open(bytes, 42).has_value());
+                expect(!StreamCacheView::open(bytes, 43).has_value());
+            };
+
+            then("a string reference past the blob should be rejected") = [&] {
+                auto corrupt = bytes;
+                const auto record = sizeof(xml_stream_parser::detail::StreamCacheHeader);
+                const std::uint32_t huge = 0xffffff00u;
+                std::memcpy(corrupt.data() + record, &huge, sizeof(huge));
+                expect(!StreamCacheView::open(corrupt, 42).has_value());
+            };
+
+            then("a malformed member list should be rejected") = [&] {
+                auto corrupt = bytes;
+                // Point the first stream's members at "res", which has no kind byte or terminator.
+                const auto members = sizeof(xml_stream_parser::detail::StreamCacheHeader) +
+                                     offsetof(xml_stream_parser::detail::StreamCacheRecord, members);
+                const xml_stream_parser::detail::StreamCacheString bad{0, 3};
+                std::memcpy(corrupt.data() + members, &bad, sizeof(bad));
+                expect(!StreamCacheView::open(corrupt, 42).has_value());
+            };
+
+            then("the view should expose the encoded values") = [&] {
+                const auto view = StreamCacheView::open(bytes, 42);
+                expect(view->size() == 2_ul);
+                expect((*view)[0].stream_id == "restart");
+                expect((*view)[0].immutable == 1_i);
+            };
+        };
+
+        given("a cache whose member list is corrupt") = [] {
+            const TempCachePair tmp{STREAMS_XML};
+            const auto reference = load_or_build(tmp.xml_path, tmp.cache_path);
+            {
+                std::fstream f{tmp.cache_path, std::ios::in | std::ios::out | std::ios::binary};
+                f.seekp(static_cast<std::streamoff>(sizeof(xml_stream_parser::detail::StreamCacheHeader) +
+                                                    offsetof(xml_stream_parser::detail::StreamCacheRecord, members)));
+                const xml_stream_parser::detail::StreamCacheString bad{0, 3};
+                f.write(reinterpret_cast<const char*>(&bad), sizeof(bad));
+            }
+
+            then("it should be rebuilt rather than throw") = [&] {
+                const auto result = load_or_build(tmp.xml_path, tmp.cache_path);
+                expect(!result.cache_hit);
+                expect(std::ranges::equal(reference.streams, result.streams));
+            };
+        };
+
+        given("an unwritable cache location") = [] {
+            const TempCachePair tmp{STREAMS_XML};
+
+            then("loading should still succeed from the XML") = [&] {
+                const auto result = load_or_build(tmp.xml_path, "/nonexistent/dir/streams.bin");
+                expect(!result.cache_hit);
+                expect(result.streams.size() == 2_ul);
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_cache();
+}
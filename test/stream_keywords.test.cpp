@@ -0,0 +1,143 @@
+#include <string>
+
+#include <ut.hpp>
+#include "parse.hpp"
+#include "stream_cache.hpp"
+#include "stream_keywords.hpp"
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+static_assert(classify_direction("input;output") == Direction::input_output);
+static_assert(classify_io_type("pnetcdf,cdf5") == IoType::pnetcdf_cdf5);
+static_assert(classify_clobber_mode("replace_files") == ClobberMode::truncate);
+static_assert(classify_precision("") == Precision::native);
+
+constexpr auto STREAMS_XML = R"(
+    <streams>
+        <stream name="history" type="output" io_type="netcdf4" clobber_mode="noappend_overwrite"/>
+        <stream name="restart" type="input output" io_type="pnetcdf,cdf5" precision="double"/>
+    </streams>
+)";
+
+/// The message of the exception `f` throws, or an empty string.
+template<typename F>
+std::string error_message(F&& f) {
+    try {
+        f();
+    } catch (const StreamKeywordError& e) {
+        return e.what();
+    }
+    return {};
+}
+
+} // namespace
+
+struct StreamKeywordsFixture {
+    pugi::xml_document doc;
+
+    StreamKeywordsFixture() { doc.load_string(STREAMS_XML); }
+
+    [[nodiscard]] PugiXmlViewAdapter root() const { return PugiXmlViewAdapter{doc.child("streams")}; }
+};
+
+void test_stream_keywords() {
+    using namespace boost::ut::bdd;
+    "strict keyword classification"_test = [] {
+        given("valid keyword lists") = [] {
+            then("every accepted spelling should map to the legacy code") = [] {
+                expect(classify_direction("input") == Direction::input);
+                expect(classify_direction(" output , input ") == Direction::input_output);
+                expect(classify_direction("none") == Direction::none);
+                expect(classify_direction("") == Direction::none);
+                expect(classify_io_type("") == IoType::pnetcdf);
+                expect(classify_io_type("pnetcdf") == IoType::pnetcdf);
+                expect(classify_io_type("cdf5:pnetcdf") == IoType::pnetcdf_cdf5);
+                expect(classify_io_type("netcdf") == IoType::netcdf);
+                expect(classify_io_type("netcdf4") == IoType::netcdf4);
+                expect(classify_clobber_mode("never_modify") == ClobberMode::never_modify);
+                expect(classify_clobber_mode("append") == ClobberMode::append);
+                expect(classify_clobber_mode("truncate, replace_files") == ClobberMode::truncate);
+                expect(classify_clobber_mode("overwrite") == ClobberMode::overwrite);
+                expect(classify_precision("single") == Precision::single);
+                expect(classify_precision("double") == Precision::double_);
+            };
+        };
+
+        given("values the substring parsers misread") = [] {
+            then("the legacy parsers should still accept them") = [] {
+                expect(parse_clobber_mode("noappend_overwrite") == 1_i);
+                expect(parse_direction("outputs") == 2_i);
+                expect(parse_precision_bytes("double_single") == 4_i);
+            };
+
+            then("strict classification should report the offending keyword") = [] {
+                expect(eq(error_message([] { (void)classify_clobber_mode("noappend_overwrite", "history"); }),
+                          "Unknown clobber_mode keyword 'noappend_overwrite' in stream 'history'"_s));
+                expect(throws<StreamKeywordError>([] { (void)classify_direction("outputs"); }));
+                expect(throws<StreamKeywordError>([] { (void)classify_io_type("hdf5"); }));
+                expect(throws<StreamKeywordError>([] { (void)classify_precision("Single"); }));
+            };
+
+            then("conflicting keywords should be reported") = [] {
+                expect(eq(error_message([] { (void)classify_precision("double_single", "s"); }),
+                          "Unknown precision keyword 'double_single' in stream 's'"_s));
+                expect(eq(error_message([] { (void)classify_precision("double single", "s"); }),
+                          "Conflicting precision keywords 'double single' in stream 's'"_s));
+                expect(throws<StreamKeywordError>([] { (void)classify_direction("none;output"); }));
+                expect(throws<StreamKeywordError>([] { (void)classify_io_type("netcdf,cdf5"); }));
+                expect(throws<StreamKeywordError>([] { (void)classify_clobber_mode("append overwrite"); }));
+            };
+        };
+    };
+
+    "keyword parsing while loading"_test = [] {
+        given("a document with a misspelled clobber mode") = [] {
+            const StreamKeywordsFixture fixture;
+
+            then("a permissive load should read it as before") = [&] {
+                StreamSet<PugiXmlViewAdapter> streams;
+                streams.load_from_xml(fixture.root());
+                expect(streams.find("history")->get_clobber_mode() == 1_i);
+            };
+
+            then("a strict load should fail and leave the set unchanged") = [&] {
+                StreamSet<PugiXmlViewAdapter> streams;
+                expect(throws<StreamKeywordError>([&] {
+                    streams.load_from_xml(fixture.root(), LoadOptions{.keywords = KeywordParsing::strict});
+                }));
+                expect(streams.empty());
+            };
+
+            then("strictness should be part of the cache key") = [] {
+                const auto bytes = std::as_bytes(std::span{std::string_view{STREAMS_XML}});
+                expect(stream_cache_key(bytes, {}) != stream_cache_key(bytes, {.keywords = KeywordParsing::strict}));
+            };
+        };
+
+        given("a document with valid keywords") = [] {
+            pugi::xml_document doc;
+            doc.load_string(R"(<streams><stream name="restart" type="input output" io_type="pnetcdf,cdf5"
+                                             precision="double" clobber_mode="truncate"/></streams>)");
+            const PugiXmlViewAdapter root{doc.child("streams")};
+
+            then("strict and permissive loads should agree") = [&] {
+                StreamSet<PugiXmlViewAdapter> permissive;
+                StreamSet<PugiXmlViewAdapter> strict;
+                permissive.load_from_xml(root);
+                strict.load_from_xml(root, LoadOptions{.parallel = true, .keywords = KeywordParsing::strict});
+                expect(*strict.find("restart") == *permissive.find("restart"));
+                expect(strict.find("restart")->get_iotype() == 1_i);
+                expect(strict.find("restart")->get_precision() == 8_i);
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_keywords();
+}
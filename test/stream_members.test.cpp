@@ -0,0 +1,238 @@
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ut.hpp>
+#include "stream_members.hpp"
+#include "stream_serialization.hpp"
+#include "stream_set.hpp"
+#include "stream_table.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+constexpr auto STREAMS_XML = R"(
+    <streams>
+        <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00">
+            <var name="xtime"/>
+        </immutable_stream>
+        <stream name="history" type="output" output_interval="6:00:00">
+            <stream name="restart"/>
+            <var name="u"/>
+            <var_struct name="tracers"/>
+            <file name="history_vars.txt"/>
+            <var name="v"/>
+            <var_array name="scalars"/>
+            <var name="u"/>
+            <file name="history_vars.txt"/>
+        </stream>
+        <stream name="diagnostics" type="output" output_interval="stream:history:output_interval">
+            <var name="xtime"/>
+        </stream>
+    </streams>
+)";
+
+std::vector<StreamMember> list(const StreamMembers& members) {
+    return {members.begin(), members.end()};
+}
+
+} // namespace
+
+struct StreamMembersFixture {
+    pugi::xml_document doc;
+    StreamSet<PugiXmlViewAdapter> streams;
+
+    StreamMembersFixture() {
+        doc.load_string(STREAMS_XML);
+        streams.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+    }
+
+    [[nodiscard]] const StreamMembers& members(std::string_view name) const {
+        return streams.find(name)->get_members();
+    }
+};
+
+void test_stream_members() {
+    using namespace boost::ut::bdd;
+    "stream members"_test = [] {
+        given("streams with file, var, var_array, var_struct and stream children") = [] {
+            const StreamMembersFixture fixture;
+            const auto& history = fixture.members("history");
+
+            then("members should be grouped by kind in MPAS order, document order within a kind") = [&] {
+                using enum MemberKind;
+                const std::vector<StreamMember> expected{
+                    {file, "history_vars.txt"}, {file, "history_vars.txt"},
+                    {var, "u"}, {var, "v"}, {var, "u"},
+                    {var_array, "scalars"}, {var_struct, "tracers"}, {stream, "restart"},
+                };
+                expect(list(history) == expected);
+                expect(history.size() == 8_ul);
+                expect(history.has_files());
+            };
+
+            then("membership should be answered by the index") = [&] {
+                expect(history.contains("u"));
+                expect(history.contains("tracers"));
+                expect(!history.contains("xtime"));
+                expect(!history.contains(""));
+                expect(history.find("scalars")->kind == MemberKind::var_array);
+                expect(!fixture.members("restart").find("u").has_value());
+            };
+
+            then("the nested <stream> member should not be loaded as a stream") = [&] {
+                expect(fixture.streams.size() == 3_ul);
+            };
+
+            then("streams with the same members should compare equal lists") = [&] {
+                expect(fixture.members("restart") == fixture.members("diagnostics"));
+                expect(!(fixture.members("restart") == history));
+            };
+        };
+
+        given("<file> members") = [] {
+            const StreamMembersFixture fixture;
+            const auto& history = fixture.members("history");
+
+            when("the list is expanded with a reader") = [&] {
+                std::map<std::string, int> reads;
+                const auto expanded = history.expand_files([&](std::string_view file) {
+                    ++reads[std::string{file}];
+                    return std::vector<std::string>{"theta", "rho"};
+                });
+
+                then("each file should be read once and replaced by its variables") = [&] {
+                    expect(reads == std::map<std::string, int>{{"history_vars.txt", 1}});
+                    expect(!expanded.has_files());
+                    expect(expanded.size() == 10_ul);
+                    expect(expanded[0] == StreamMember{MemberKind::var, "theta"});
+                    expect(expanded[2] == StreamMember{MemberKind::var, "theta"});
+                    expect(expanded.contains("rho"));
+                    expect(expanded.contains("tracers"));
+                };
+            };
+
+            when("the list is expanded from a directory") = [&] {
+                const auto dir = std::filesystem::temp_directory_path();
+                {
+                    std::ofstream out{dir / "history_vars.txt"};
+                    out << "  w \n\n\tke\r\n";
+                }
+                const auto expanded = history.expand_files(dir);
+                std::filesystem::remove(dir / "history_vars.txt");
+
+                then("names should be read one per line, trimmed, blank lines skipped") = [&] {
+                    expect(expanded[0] == StreamMember{MemberKind::var, "w"});
+                    expect(expanded[1] == StreamMember{MemberKind::var, "ke"});
+                    expect(expanded.size() == 10_ul);
+                };
+
+                then("a missing file should be reported") = [&] {
+                    expect(throws<std::runtime_error>([&] {
+                        (void)history.expand_files(dir / "no_such_directory");
+                    }));
+                };
+            };
+        };
+
+        given("a member element without a name") = [] {
+            pugi::xml_document doc;
+            doc.load_string(R"(<streams><stream name="broken" type="output"><var/></stream></streams>)");
+
+            then("loading should fail") = [&] {
+                StreamSet<PugiXmlAdapter> streams;
+                expect(throws<std::runtime_error>([&] {
+                    streams.load_from_xml(PugiXmlAdapter{doc.child("streams")});
+                }));
+            };
+        };
+
+        given("a large variable list") = [] {
+            std::string xml = R"(<streams><stream name="big" type="output">)";
+            for (int v = 0; v < 20000; ++v)
+                xml += std::format(R"(<var name="field_{}"/>)", v);
+            xml += "</stream></streams>";
+            pugi::xml_document doc;
+            doc.load_string(xml.c_str());
+            StreamSet<PugiXmlViewAdapter> streams;
+            streams.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+            const auto& members = streams.find("big")->get_members();
+
+            then("every variable should be listed and found") = [&] {
+                expect(members.size() == 20000_ul);
+                bool all_found = true;
+                for (int v = 0; v < 20000; ++v)
+                    all_found = all_found && members.contains(std::format("field_{}", v));
+                expect(all_found);
+                expect(!members.contains("field_20000"));
+            };
+        };
+    };
+
+    "stream members across representations"_test = [] {
+        given("a loaded set") = [] {
+            const StreamMembersFixture fixture;
+
+            then("members should survive serialization") = [&] {
+                const auto restored = deserialize(serialize(fixture.streams));
+                expect(restored.find("history")->get_members() == fixture.members("history"));
+                expect(restored.find("history")->get_members().contains("scalars"));
+            };
+
+            then("a table-backed load should list the same members") = [&] {
+                const StreamTable table{STREAMS_XML};
+                StreamSet<StreamTable::Node> streams;
+                streams.load_from_xml(table.root());
+                const bool same = serialize(streams) == serialize(fixture.streams);
+                expect(same);
+            };
+
+            then("a streams-only table should list none") = [&] {
+                const StreamTable table{STREAMS_XML, StreamTable::Contents::streams};
+                StreamSet<StreamTable::Node> streams;
+                streams.load_from_xml(table.root());
+                expect(streams.find("history")->get_members().empty());
+            };
+        };
+
+        given("an interned set") = [] {
+            pugi::xml_document doc;
+            doc.load_string(STREAMS_XML);
+            InternedStreamSet<PugiXmlViewAdapter> streams;
+            streams.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+
+            then("identical member lists should share storage") = [&] {
+                const std::string_view restart{streams.find("restart")->get_members().encoded()};
+                const std::string_view diagnostics{streams.find("diagnostics")->get_members().encoded()};
+                expect(restart.data() == diagnostics.data());
+                expect(streams.find("diagnostics")->get_members().contains("xtime"));
+            };
+        };
+
+        given("a reload that only edits a variable list") = [] {
+            StreamMembersFixture fixture;
+            std::string edited{STREAMS_XML};
+            edited.replace(edited.find(R"(<var name="v"/>)"), 15, R"(<var name="w"/>)");
+            pugi::xml_document doc;
+            doc.load_string(edited.c_str());
+            const auto changes = fixture.streams.reload(PugiXmlViewAdapter{doc.child("streams")});
+
+            then("the stream should be reported as modified") = [&] {
+                expect(changes.modified == std::vector<std::string>{"history"});
+                expect(fixture.members("history").contains("w"));
+                expect(!fixture.members("history").contains("v"));
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_members();
+}
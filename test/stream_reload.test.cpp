@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <ut.hpp>
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+constexpr auto BASE_STREAMS = R"(
+    <streams>
+        <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00"/>
+        <immutable_stream name="shared" type="input" input_interval="3h"/>
+        <stream name="history" type="output" output_interval="stream:restart:output_interval"/>
+        <stream name="archive" type="output" output_interval="12:00:00"/>
+        <stream name="diagnostics" type="output" output_interval="stream:archive:output_interval"/>
+        <stream name="summary" type="output" output_interval="stream:diagnostics:output_interval"/>
+        <stream name="shared" type="output" output_interval="9h"/>
+        <stream name="forcing" type="input" input_interval="stream:shared:input_interval"/>
+    </streams>
+)";
+
+bool same_names(std::vector<std::string> actual, std::vector<std::string> expected) {
+    std::ranges::sort(actual);
+    std::ranges::sort(expected);
+    return actual == expected;
+}
+
+} // namespace
+
+struct StreamReloadFixture {
+    pugi::xml_document base;
+    pugi::xml_document edited;
+    StreamSet<PugiXmlAdapter> streams;
+    LoadStats stats;
+
+    StreamReloadFixture() {
+        base.load_string(BASE_STREAMS);
+        streams.load_from_xml(PugiXmlAdapter{base.child("streams")});
+    }
+
+    /// Reloads from `xml`, counting the streams actually re-resolved in `stats`.
+    StreamChangeSet reload(const char* xml, LoadOptions options = {}) {
+        edited.load_string(xml);
+        stats = {};
+        options.stats = &stats;
+        return streams.reload(PugiXmlAdapter{edited.child("streams")}, options);
+    }
+
+    /// True if the set equals a full load of the last reloaded document.
+    [[nodiscard]] bool matches_full_load() const {
+        StreamSet<PugiXmlAdapter> fresh;
+        fresh.load_from_xml(PugiXmlAdapter{edited.child("streams")});
+        return fresh.streams() == streams.streams();
+    }
+};
+
+void test_stream_reload() {
+    using namespace boost::ut::bdd;
+    "incremental stream reload"_test = [] {
+        given("an unchanged document") = [] {
+            StreamReloadFixture fixture;
+            const auto changes = fixture.reload(BASE_STREAMS);
+
+            then("nothing should be reported or reloaded") = [&] {
+                expect(changes.empty());
+                expect(fixture.stats.streams == 0_ul);
+                expect(fixture.matches_full_load());
+            };
+        };
+
+        given("a document with its attributes reordered") = [] {
+            StreamReloadFixture fixture;
+            const auto changes = fixture.reload(R"(
+                <streams>
+                    <immutable_stream type="input output" output_interval="1_00:00:00" input_interval="initial_only" name="restart"/>
+                    <immutable_stream name="shared" type="input" input_interval="3h"/>
+                    <stream name="history" type="output" output_interval="stream:restart:output_interval"/>
+                    <stream name="archive" type="output" output_interval="12:00:00"/>
+                    <stream name="diagnostics" type="output" output_interval="stream:archive:output_interval"/>
+                    <stream name="summary" type="output" output_interval="stream:diagnostics:output_interval"/>
+                    <stream name="shared" type="output" output_interval="9h"/>
+                    <stream name="forcing" type="input" input_interval="stream:shared:input_interval"/>
+                </streams>
+            )");
+
+            then("no stream should be reloaded") = [&] {
+                expect(changes.empty());
+                expect(fixture.stats.streams == 0_ul);
+            };
+        };
+
+        given("a stream referenced through a chain is edited") = [] {
+            StreamReloadFixture fixture;
+            const auto changes = fixture.reload(R"(
+                <streams>
+                    <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00"/>
+                    <immutable_stream name="shared" type="input" input_interval="3h"/>
+                    <stream name="history" type="output" output_interval="stream:restart:output_interval"/>
+                    <stream name="archive" type="output" output_interval="6:00:00"/>
+                    <stream name="diagnostics" type="output" output_interval="stream:archive:output_interval"/>
+                    <stream name="summary" type="output" output_interval="stream:diagnostics:output_interval"/>
+                    <stream name="shared" type="output" output_interval="9h"/>
+                    <stream name="forcing" type="input" input_interval="stream:shared:input_interval"/>
+                </streams>
+            )");
+
+            then("the stream and everything resolving through it should be reloaded") = [&] {
+                expect(fixture.stats.streams == 3_ul);
+                expect(same_names(changes.modified, {"archive", "diagnostics", "summary"}));
+                expect(changes.added.empty());
+                expect(changes.removed.empty());
+                expect(eq(fixture.streams.find("summary")->get_filename_interval(), "6:00:00"_s));
+                expect(fixture.matches_full_load());
+            };
+        };
+
+        given("an attribute edit that does not change any resolved value") = [] {
+            StreamReloadFixture fixture;
+            const auto changes = fixture.reload(R"(
+                <streams>
+                    <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00"/>
+                    <immutable_stream name="shared" type="input" input_interval="3h"/>
+                    <stream name="history" type="output" output_interval="stream:restart:output_interval"/>
+                    <stream name="archive" type="output" output_interval="12:00:00" comment="nightly"/>
+                    <stream name="diagnostics" type="output" output_interval="stream:archive:output_interval"/>
+                    <stream name="summary" type="output" output_interval="stream:diagnostics:output_interval"/>
+                    <stream name="shared" type="output" output_interval="9h"/>
+                    <stream name="forcing" type="input" input_interval="stream:shared:input_interval"/>
+                </streams>
+            )");
+
+            then("the dependents should be re-resolved but not reported as modified") = [&] {
+                expect(fixture.stats.streams == 3_ul);
+                expect(changes.empty());
+            };
+        };
+
+        given("a stream is added and another removed") = [] {
+            StreamReloadFixture fixture;
+            const auto changes = fixture.reload(R"(
+                <streams>
+                    <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00"/>
+                    <immutable_stream name="shared" type="input" input_interval="3h"/>
+                    <stream name="archive" type="output" output_interval="12:00:00"/>
+                    <stream name="diagnostics" type="output" output_interval="stream:archive:output_interval"/>
+                    <stream name="summary" type="output" output_interval="stream:diagnostics:output_interval"/>
+                    <stream name="shared" type="output" output_interval="9h"/>
+                    <stream name="forcing" type="input" input_interval="stream:shared:input_interval"/>
+                    <stream name="surface" type="output" output_interval="stream:restart:output_interval"/>
+                </streams>
+            )");
+
+            then("only the new stream should be loaded") = [&] {
+                expect(fixture.stats.streams == 1_ul);
+                expect(same_names(changes.added, {"surface"}));
+                expect(same_names(changes.removed, {"history"}));
+                expect(changes.modified.empty());
+                expect(!fixture.streams.contains("history"));
+                expect(fixture.matches_full_load());
+            };
+        };
+
+        given("the immutable stream shadowing a mutable one is edited") = [] {
+            StreamReloadFixture fixture;
+            const auto changes = fixture.reload(R"(
+                <streams>
+                    <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00"/>
+                    <immutable_stream name="shared" type="input" input_interval="1h"/>
+                    <stream name="history" type="output" output_interval="stream:restart:output_interval"/>
+                    <stream name="archive" type="output" output_interval="12:00:00"/>
+                    <stream name="diagnostics" type="output" output_interval="stream:archive:output_interval"/>
+                    <stream name="summary" type="output" output_interval="stream:diagnostics:output_interval"/>
+                    <stream name="shared" type="output" output_interval="9h"/>
+                    <stream name="forcing" type="input" input_interval="stream:shared:input_interval"/>
+                </streams>
+            )");
+
+            then("references should follow the immutable stream and the mutable one be kept") = [&] {
+                expect(fixture.stats.streams == 2_ul);
+                expect(same_names(changes.modified, {"shared", "forcing"}));
+                expect(eq(fixture.streams.find("forcing")->get_filename_interval(), "1h"_s));
+                expect(fixture.matches_full_load());
+            };
+        };
+
+        given("a reload that removes a referenced stream") = [] {
+            StreamReloadFixture fixture;
+
+            then("it should throw and leave the set unchanged") = [&] {
+                expect(throws<StreamIntervalError>([&] {
+                    (void)fixture.reload(R"(
+                        <streams>
+                            <stream name="diagnostics" type="output" output_interval="stream:archive:output_interval"/>
+                        </streams>
+                    )");
+                }));
+                expect(fixture.streams.size() == 8_ul);
+                expect(eq(fixture.streams.find("diagnostics")->get_filename_interval(), "12:00:00"_s));
+            };
+        };
+
+        given("an unchanged document reloaded with a tighter depth limit") = [] {
+            StreamReloadFixture fixture;
+
+            then("every stream should be re-resolved against the new limit") = [&] {
+                expect(throws<StreamIntervalError>([&] {
+                    (void)fixture.reload(BASE_STREAMS, LoadOptions{.intervals = {.max_depth = 1}});
+                }));
+                expect(fixture.streams.size() == 8_ul);
+                expect(eq(fixture.streams.find("summary")->get_filename_interval(), "12:00:00"_s));
+            };
+        };
+
+        given("an unchanged document reloaded with different keyword parsing") = [] {
+            StreamReloadFixture fixture;
+            const auto changes = fixture.reload(BASE_STREAMS, LoadOptions{.keywords = KeywordParsing::strict});
+
+            then("every stream should be reloaded but none reported as modified") = [&] {
+                expect(fixture.stats.streams == 8_ul);
+                expect(changes.empty());
+            };
+        };
+
+        given("a set restored without fingerprints") = [] {
+            StreamReloadFixture fixture;
+            auto copy = fixture.streams.streams();
+            fixture.streams.assign(std::move(copy));
+            const auto changes = fixture.reload(BASE_STREAMS);
+
+            then("every stream should be reloaded but none reported as modified") = [&] {
+                expect(fixture.stats.streams == 8_ul);
+                expect(changes.empty());
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_reload();
+}
@@ -0,0 +1,157 @@
+#include <ut.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "stream_serialization.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+constexpr const char* STREAMS_XML = R"(
+    <streams>
+        <immutable_stream name="restart" type="input output" filename_template="restart.$Y-$M-$D_$h.nc"
+                          input_interval="initial_only" output_interval="1_00:00:00"
+                          reference_time="0001-01-01_00:00:00" precision="double"/>
+        <stream name="history" type="output" filename_template="history.$Y-$M-$D_$h.nc"
+                output_interval="stream:restart:output_interval" io_type="netcdf4" clobber_mode="truncate"/>
+        <stream name="diagnostics" type="output" filename_template="diag.$Y-$M-$D_$h.nc"
+                output_interval="1_00:00:00" reference_time="0001-01-01_00:00:00"/>
+    </streams>
+)";
+
+struct SerializationFixture {
+    pugi::xml_document doc;
+    StreamSet<PugiXmlAdapter> streams;
+
+    SerializationFixture() {
+        doc.load_string(STREAMS_XML);
+        streams.load_from_xml(PugiXmlAdapter{doc.child("streams")});
+    }
+};
+
+bool write_all(int fd, std::span<const std::byte> bytes) {
+    while (!bytes.empty()) {
+        const auto n = ::write(fd, bytes.data(), bytes.size());
+        if (n <= 0)
+            return false;
+        bytes = bytes.subspan(static_cast<std::size_t>(n));
+    }
+    return true;
+}
+
+std::vector<std::byte> read_all(int fd) {
+    std::vector<std::byte> bytes;
+    std::array<std::byte, 4096> chunk;
+    for (ssize_t n; (n = ::read(fd, chunk.data(), chunk.size())) > 0;)
+        bytes.insert(bytes.end(), chunk.begin(), chunk.begin() + n);
+    return bytes;
+}
+
+} // namespace
+
+void test_stream_serialization() {
+    using namespace boost::ut::bdd;
+    "stream serialization behavior"_test = [] {
+        given("a resolved stream set") = [] {
+            const SerializationFixture fixture;
+
+            when("it is serialized and deserialized in the same process") = [&] {
+                const auto buffer   = serialize(fixture.streams);
+                const auto restored = deserialize<PugiXmlAdapter>(buffer);
+
+                then("the streams should be identical and findable by name") = [&] {
+                    expect(std::ranges::equal(fixture.streams, restored));
+                    expect(eq(restored.find("history")->get_filename_interval(), "1_00:00:00"_s));
+                };
+            };
+
+            when("the buffer is copied to a new location before deserializing") = [&] {
+                const auto buffer = serialize(fixture.streams);
+                std::vector<std::byte> shifted(buffer.size() + 1);
+                std::ranges::copy(buffer, shifted.begin() + 1);
+                const auto restored = deserialize(std::span{shifted}.subspan(1));
+
+                then("the unaligned copy should decode to the same values") = [&] {
+                    expect(restored.size() == fixture.streams.size());
+                    expect(eq(restored.find("restart")->get_reference_time(), "0001-01-01_00:00:00"_s));
+                };
+            };
+
+            when("several streams share the same attribute values") = [&] {
+                const auto buffer = serialize(fixture.streams);
+                std::size_t text = 0;
+                for (const auto& s : fixture.streams)
+                    text += s.get_stream_id().size() + s.get_filename_template().size() +
+                            s.get_filename_interval().size() + s.get_reference_time().size() +
+                            s.get_record_interval().size();
+
+                then("repeated strings should be stored once") = [&] {
+                    const auto fixed = sizeof(xml_stream_parser::detail::StreamCacheHeader) +
+                                       fixture.streams.size() * sizeof(xml_stream_parser::detail::StreamCacheRecord);
+                    expect(buffer.size() < fixed + text);
+                };
+            };
+
+            when("the buffer is sent from a forked root process through a pipe") = [&] {
+                int fds[2];
+                expect(fatal(::pipe(fds) == 0));
+
+                const pid_t pid = ::fork();
+                expect(fatal(pid >= 0));
+                if (pid == 0) {
+                    // Root rank: parse once and broadcast.
+                    ::close(fds[0]);
+                    pugi::xml_document doc;
+                    doc.load_string(STREAMS_XML);
+                    StreamSet<PugiXmlViewAdapter> root_streams;
+                    root_streams.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+                    const bool ok = write_all(fds[1], serialize(root_streams));
+                    ::close(fds[1]);
+                    std::_Exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+                }
+
+                ::close(fds[1]);
+                const auto received = read_all(fds[0]);
+                ::close(fds[0]);
+                int status = 0;
+                ::waitpid(pid, &status, 0);
+
+                then("the receiving process should reconstruct the same streams without parsing") = [&] {
+                    expect(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+                    const auto restored = deserialize<PugiXmlAdapter>(received);
+                    expect(std::ranges::equal(fixture.streams, restored));
+                };
+            };
+        };
+
+        given("buffers that are not valid serialized streams") = [] {
+            const SerializationFixture fixture;
+            const auto buffer = serialize(fixture.streams);
+
+            then("a truncated buffer should throw a runtime_error") = [&] {
+                expect(throws<std::runtime_error>([&] {
+                    (void)deserialize(std::span{buffer}.first(buffer.size() - 1));
+                }));
+            };
+
+            then("an empty buffer should throw a runtime_error") = [] {
+                expect(throws<std::runtime_error>([] {
+                    (void)deserialize(std::span<const std::byte>{});
+                }));
+            };
+
+            then("a stream cache file keyed to a source should be rejected") = [&] {
+                const auto cache = encode_stream_cache(fixture.streams, 1234);
+                expect(throws<std::runtime_error>([&] { (void)deserialize(cache); }));
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_serialization();
+}
@@ -0,0 +1,82 @@
+#include <ut.hpp>
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+struct XmlStreamSetFixture {
+    pugi::xml_document doc;
+    StreamSet<PugiXmlAdapter> streams;
+
+    XmlStreamSetFixture() {
+        doc.load_string(R"(
+            <streams>
+                <immutable_stream name="restart" type="input output" input_interval="initial_only" output_interval="1_00:00:00"/>
+                <immutable_stream name="shared" type="input" input_interval="3h"/>
+                <stream name="history" type="output" output_interval="stream:restart:output_interval"/>
+                <stream name="archive" type="output" output_interval="12:00:00"/>
+                <stream name="diagnostics" type="output" output_interval="stream:archive:output_interval"/>
+                <stream name="shared" type="output" output_interval="9h"/>
+                <stream name="forcing" type="input" input_interval="stream:shared:input_interval"/>
+            </streams>
+        )");
+        streams.load_from_xml(PugiXmlAdapter{doc.child("streams")});
+    }
+};
+
+void test_stream_set() {
+    using namespace boost::ut::bdd;
+    "stream set loading"_test = [] {
+        given("a document with immutable and mutable streams") = [] {
+            const XmlStreamSetFixture fixture;
+
+            when("the whole document is loaded at once") = [&] {
+                then("every named stream should be loaded, immutable streams first") = [&] {
+                    expect(fixture.streams.size() == 7_ul);
+                    expect(eq(fixture.streams.streams().front().get_stream_id(), "restart"_s));
+                    expect(fixture.streams.streams().front().get_immutable() == 1_i);
+                    expect(fixture.streams.streams().back().get_immutable() == 0_i);
+                };
+
+                then("streams should be found by name") = [&] {
+                    expect(fixture.streams.contains("history"));
+                    expect(!fixture.streams.contains("missing"));
+                };
+
+                then("references to immutable streams should resolve through the index") = [&] {
+                    expect(eq(fixture.streams.find("history")->get_filename_interval(), "1_00:00:00"_s));
+                };
+
+                then("references to mutable streams should resolve through the index") = [&] {
+                    expect(eq(fixture.streams.find("diagnostics")->get_filename_interval(), "12:00:00"_s));
+                };
+
+                then("an immutable stream should take precedence over a mutable stream of the same name") = [&] {
+                    expect(eq(fixture.streams.find("forcing")->get_filename_interval(), "3h"_s));
+                    expect(fixture.streams.find("shared")->get_immutable() == 1_i);
+                };
+            };
+        };
+
+        given("a document referencing a stream that does not exist") = [] {
+            pugi::xml_document doc;
+            doc.load_string(R"(
+                <streams>
+                    <stream name="orphan" type="output" output_interval="stream:nowhere:output_interval"/>
+                </streams>
+            )");
+
+            then("loading should throw a StreamIntervalError") = [&] {
+                StreamSet<PugiXmlAdapter> streams;
+                expect(throws<StreamIntervalError>([&] {
+                    streams.load_from_xml(PugiXmlAdapter{doc.child("streams")});
+                }));
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_set();
+}
@@ -0,0 +1,88 @@
+#include <ut.hpp>
+#include "stream_set.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+/// Streams s0..s{count-1}; every stream but s0 references s0's output interval.
+std::string make_streams_xml(std::size_t count, std::initializer_list<std::size_t> broken = {}) {
+    std::string xml = R"(<streams><immutable_stream name="s0" type="output" output_interval="6:00:00"/>)";
+    for (std::size_t i = 1; i < count; ++i) {
+        const bool is_broken = std::ranges::find(broken, i) != broken.end();
+        xml += "<stream name=\"s" + std::to_string(i) + "\" type=\"output\" precision=\"" +
+               (i % 2 ? "single" : "double") + "\" output_interval=\"stream:" +
+               (is_broken ? "missing" + std::to_string(i) : "s0"_s) + ":output_interval\"/>";
+    }
+    return xml + "</streams>";
+}
+
+constexpr LoadOptions parallel_options{.parallel = true, .max_threads = 4, .min_streams_per_thread = 16};
+
+} // namespace
+
+void test_stream_set_parallel() {
+    using namespace boost::ut::bdd;
+    "parallel stream set loading"_test = [] {
+        given("a document with many valid streams") = [] {
+            pugi::xml_document doc;
+            const auto xml = make_streams_xml(1000);
+            doc.load_string(xml.c_str());
+            const PugiXmlAdapter root{doc.child("streams")};
+
+            when("it is loaded serially and in parallel") = [&] {
+                StreamSet<PugiXmlAdapter> serial;
+                StreamSet<PugiXmlAdapter> parallel;
+                serial.load_from_xml(root);
+                parallel.load_from_xml(root, parallel_options);
+
+                then("both loads should produce identical streams in identical order") = [&] {
+                    expect(parallel.size() == 1000_ul);
+                    expect(serial.streams() == parallel.streams());
+                    expect(eq(parallel.find("s999")->get_filename_interval(), "6:00:00"_s));
+                };
+            };
+        };
+
+        given("a document with failures in several chunks") = [] {
+            pugi::xml_document doc;
+            const auto xml = make_streams_xml(1000, {900, 250, 600});
+            doc.load_string(xml.c_str());
+            const PugiXmlAdapter root{doc.child("streams")};
+
+            then("the parallel load should report the same first error as the serial load") = [&] {
+                std::string serial_error;
+                std::string parallel_error;
+                try {
+                    StreamSet<PugiXmlAdapter>{}.load_from_xml(root);
+                } catch (const StreamIntervalError& e) {
+                    serial_error = e.what();
+                }
+                try {
+                    StreamSet<PugiXmlAdapter>{}.load_from_xml(root, parallel_options);
+                } catch (const StreamIntervalError& e) {
+                    parallel_error = e.what();
+                }
+                expect(eq(serial_error, "Referenced stream 'missing250' not found"_s));
+                expect(eq(parallel_error, serial_error));
+            };
+
+            then("a failed load should leave previously loaded streams untouched") = [&] {
+                pugi::xml_document good;
+                const auto good_xml = make_streams_xml(10);
+                good.load_string(good_xml.c_str());
+
+                StreamSet<PugiXmlAdapter> set;
+                set.load_from_xml(PugiXmlAdapter{good.child("streams")});
+                expect(throws<StreamIntervalError>([&] { set.load_from_xml(root, parallel_options); }));
+                expect(set.size() == 10_ul);
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_set_parallel();
+}
@@ -0,0 +1,139 @@
+#include <string>
+#include <vector>
+
+#include <ut.hpp>
+#include "stream_serialization.hpp"
+#include "stream_table.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+namespace {
+
+constexpr std::string_view STREAMS_XML = R"(<?xml version="1.0"?>
+<!DOCTYPE streams>
+<streams>
+    <!-- Model restart <stream name="ignored"/> -->
+    <immutable_stream name="restart" type="input output" filename_template="restart.$Y-$M-$D.nc"
+                      input_interval="initial_only" output_interval="1_00:00:00"/>
+    <stream name="history" type="output" filename_template="out/history.$Y.nc"
+            output_interval="stream:restart:output_interval">
+        <var name="u"/>
+        <var name="v"/>
+        <var_array name="scalars"><var name="qv"/></var_array>
+        <stream name="nested_is_not_a_stream"/>
+    </stream>
+    <stream name='diagnostics' type="output" filename_template="out/diag.nc"
+            output_interval="stream:history:output_interval"><![CDATA[ <stream name="cdata"/> ]]></stream>
+</streams>
+)";
+
+} // namespace
+
+struct StreamTableFixture {
+    StreamTable table{STREAMS_XML};
+};
+
+void test_stream_table() {
+    using namespace boost::ut::bdd;
+    "pull parser"_test = [] {
+        given("an element with encoded attribute values") = [] {
+            XmlPullParser parser{R"(<a x="1 &lt; 2 &amp;&amp; &#65;&#x42;" y='it&apos;s' z="tab	here"/>)"};
+
+            then("values should be decoded and whitespace normalized") = [&] {
+                expect(parser.next() == XmlPullParser::Event::start_element);
+                expect(eq(parser.name(), "a"_s));
+                expect(parser.attributes().size() == 3_ul);
+                expect(eq(parser.attributes()[0].value, "1 < 2 && AB"_s));
+                expect(eq(parser.attributes()[1].value, "it's"_s));
+                expect(eq(parser.attributes()[2].value, "tab here"_s));
+                expect(parser.next() == XmlPullParser::Event::end_element);
+                expect(parser.next() == XmlPullParser::Event::end_document);
+            };
+        };
+
+        given("attribute values spanning lines") = [] {
+            XmlPullParser parser{"<a crlf=\"input\r\noutput\" cr=\"a\rb\" lf=\"a\n\nb\" ref=\"a&#13;&#10;b\"/>"};
+
+            then("line breaks should become spaces as pugixml makes them") = [&] {
+                expect(parser.next() == XmlPullParser::Event::start_element);
+                expect(eq(parser.attributes()[0].value, "input output"_s));
+                expect(eq(parser.attributes()[1].value, "a b"_s));
+                expect(eq(parser.attributes()[2].value, "a  b"_s));
+                expect(eq(parser.attributes()[3].value, "a\r\nb"_s));
+            };
+        };
+
+        given("malformed documents") = [] {
+            then("each should be rejected") = [] {
+                for (const auto* xml : {"<a><b></a>", "<a>", "<a x=1/>", "<a x=\"&bogus;\"/>", "<a><!-- </a>"}) {
+                    expect(throws<std::runtime_error>([&] {
+                        XmlPullParser parser{xml};
+                        while (parser.next() != XmlPullParser::Event::end_document) {}
+                    })) << xml;
+                }
+            };
+        };
+    };
+
+    "stream table"_test = [] {
+        given("a document with nested variables, comments and CDATA") = [] {
+            const StreamTableFixture fixture;
+
+            then("only the top-level stream elements should be kept") = [&] {
+                expect(fixture.table.size() == 3_ul);
+                expect(eq(fixture.table.root().name(), "streams"_s));
+
+                std::vector<std::string> names;
+                for (const auto& node : fixture.table.root().children("stream"))
+                    names.emplace_back(node.get_attribute("name"));
+                expect(names == std::vector<std::string>{"history", "diagnostics"});
+            };
+
+            then("attributes should be readable from the table") = [&] {
+                const auto restart = *fixture.table.root().children("immutable_stream").begin();
+                expect(restart.has_attribute("input_interval"));
+                expect(!restart.has_attribute("precision"));
+                expect(eq(restart.get_attribute("output_interval"), "1_00:00:00"_s));
+            };
+
+            when("a stream set is loaded from the table") = [&] {
+                StreamSet<StreamTable::Node> streams;
+                streams.load_from_xml(fixture.table.root());
+
+                pugi::xml_document doc;
+                doc.load_string(std::string(STREAMS_XML).c_str());
+                StreamSet<PugiXmlViewAdapter> reference;
+                reference.load_from_xml(PugiXmlViewAdapter{doc.child("streams")});
+
+                then("it should equal a set loaded from the DOM, references resolved") = [&] {
+                    expect(eq(streams.find("diagnostics")->get_filename_interval(), "1_00:00:00"_s));
+                    const bool same = serialize(streams) == serialize(reference);
+                    expect(same);
+                };
+            };
+        };
+
+        given("a document whose size is dominated by variable lists") = [] {
+            std::string xml = "<streams>";
+            for (int s = 0; s < 20; ++s) {
+                xml += std::format(R"(<stream name="s{}" type="output" output_interval="6:00:00">)", s);
+                for (int v = 0; v < 500; ++v)
+                    xml += std::format(R"(<var name="variable_with_a_long_name_{}"/>)", v);
+                xml += "</stream>";
+            }
+            xml += "</streams>";
+            const StreamTable table{xml, StreamTable::Contents::streams};
+
+            then("a streams-only table should be a small fraction of the document") = [&] {
+                expect(table.size() == 20_ul);
+                expect(table.memory_usage() * 100 < xml.size()) << table.memory_usage() << "of" << xml.size();
+            };
+        };
+    };
+}
+
+int main() {
+    test_stream_table();
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <ut.hpp>
+#include "stream_serialization.hpp"
+#include "stream_set.hpp"
+#include "string_pool.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+
+struct StringPoolFixture {
+    pugi::xml_document doc;
+
+    StringPoolFixture() {
+        std::string xml = "<streams>\n";
+        for (int i = 0; i < 100; ++i)
+            xml += std::format(R"(<stream name="s{}" type="output" filename_template="history.$Y-$M-$D.nc"
+                                          output_interval="6:00:00" reference_time="0001-01-01_00:00:00"
+                                          precision="double" io_type="pnetcdf,cdf5"/>)", i);
+        xml += "</streams>\n";
+        doc.load_string(xml.c_str());
+    }
+
+    [[nodiscard]] PugiXmlAdapter root() const { return PugiXmlAdapter{doc.child("streams")}; }
+};
+
+void test_string_pool() {
+    using namespace boost::ut::bdd;
+    "string interning"_test = [] {
+        given("a string pool") = [] {
+            StringPool pool;
+
+            then("equal values should share storage") = [&] {
+                const auto a = pool.intern("6:00:00");
+                const auto b = pool.intern(std::string{"6:00:00"});
+                expect(a == b);
+                expect(a.data() == b.data());
+                expect(pool.size() == 1_ul);
+            };
+
+            then("different values should compare unequal and by content against views") = [&] {
+                const auto a = pool.intern("none");
+                const auto b = pool.intern("initial_time");
+                expect(!(a == b));
+                expect(a == std::string_view{"none"});
+            };
+
+            then("empty values should not be stored") = [&] {
+                const auto before = pool.bytes();
+                const auto empty = pool.intern("");
+                expect(empty.empty());
+                expect(pool.bytes() == before);
+                expect(empty == InternedString{});
+            };
+
+            then("assigning from another pool should re-intern into the target's pool") = [&] {
+                StringPool other;
+                auto target = pool.intern("x");
+                const auto source = other.intern("shared_value");
+                target = source;
+                expect(target == std::string_view{"shared_value"});
+                expect(target.data() == pool.intern("shared_value").data());
+            };
+
+            then("strings from different pools should compare by content") = [&] {
+                StringPool other;
+                expect(pool.intern("6:00:00") == other.intern("6:00:00"));
+                expect(!(pool.intern("6:00:00") == other.intern("1:00:00")));
+            };
+
+            then("an unpooled string should refuse assignment") = [] {
+                InternedString s;
+                expect(throws<std::logic_error>([&] { s = std::string_view{"value"}; }));
+            };
+        };
+
+        given("an interned stream set") = [] {
+            const StringPoolFixture fixture;
+            InternedStreamSet<PugiXmlAdapter> interned;
+            interned.load_from_xml(fixture.root());
+
+            StreamSet<PugiXmlAdapter> reference;
+            reference.load_from_xml(fixture.root());
+
+            then("it should load the same values as the default set") = [&] {
+                expect(interned.size() == reference.size());
+                const auto* s7 = interned.find("s7");
+                expect(fatal(s7 != nullptr));
+                expect(s7->get_reference_time() == std::string_view{"0001-01-01_00:00:00"});
+                expect(s7->get_filename_interval() == std::string_view{"6:00:00"});
+                const bool same_bytes = serialize(interned.stream_set()) == serialize(reference);
+                expect(same_bytes);
+            };
+
+            then("repeated values should be stored once across streams") = [&] {
+                const auto& first = interned.streams().front();
+                const auto& last  = interned.streams().back();
+                expect(first.get_reference_time().data() == last.get_reference_time().data());
+                expect(first.get_filename_template().data() == last.get_filename_template().data());
+                // 100 distinct names plus a handful of shared values.
+                expect(interned.pool().size() < 110_ul);
+            };
+
+            then("stream equality should follow the interned values") = [&] {
+                expect(interned.streams()[0] == interned.streams()[0]);
+                expect(!(interned.streams()[0] == interned.streams()[1]));
+            };
+
+            when("the set is moved") = [&] {
+                InternedStreamSet<PugiXmlAdapter> moved{std::move(interned)};
+                InternedStreamSet<PugiXmlAdapter> assigned;
+                assigned = std::move(moved);
+
+                then("its streams should remain valid") = [&] {
+                    expect(assigned.size() == 100_ul);
+                    expect(assigned.find("s42")->get_stream_id() == std::string_view{"s42"});
+                };
+            };
+        };
+
+        given("an interned stream set reloaded many times") = [] {
+            const StringPoolFixture fixture;
+            InternedStreamSet<PugiXmlAdapter> interned;
+            interned.load_from_xml(fixture.root());
+            const auto loaded_size = interned.pool().size();
+
+            pugi::xml_document edited;
+            std::vector<std::size_t> sizes;
+            for (int i = 0; i < 20; ++i) {
+                const auto xml = std::format(R"(<streams><stream name="s0" type="output" output_interval="{}:00:00"/></streams>)", i + 1);
+                edited.load_string(xml.c_str());
+                (void)interned.reload(PugiXmlAdapter{edited.child("streams")});
+                sizes.push_back(interned.pool().size());
+            }
+            (void)interned.reload(fixture.root());
+            const auto kept = interned.reload(fixture.root());
+
+            then("the pool should only hold the current document's values") = [&] {
+                expect(std::ranges::all_of(sizes, [&](std::size_t n) { return n == sizes.front(); }));
+                expect(interned.pool().size() == loaded_size);
+            };
+
+            then("kept streams should be re-interned into the new pool") = [&] {
+                expect(kept.empty());
+                const auto* s7 = interned.find("s7");
+                expect(fatal(s7 != nullptr));
+                expect(s7->get_output_interval() == std::string_view{"6:00:00"});
+                expect(s7->get_output_interval().data() == interned.streams()[8].get_output_interval().data());
+            };
+        };
+
+        given("an interned stream reloaded only because a stream it follows changed") = [] {
+            pugi::xml_document base;
+            pugi::xml_document edited;
+            base.load_string(R"(<streams>
+                <stream name="history" type="output" filename_template="a.nc" output_interval="6:00:00"/>
+                <stream name="diag" type="output" output_interval="stream:history:output_interval"/>
+            </streams>)");
+            edited.load_string(R"(<streams>
+                <stream name="history" type="output" filename_template="b.nc" output_interval="6:00:00"/>
+                <stream name="diag" type="output" output_interval="stream:history:output_interval"/>
+            </streams>)");
+            InternedStreamSet<PugiXmlAdapter> interned;
+            interned.load_from_xml(PugiXmlAdapter{base.child("streams")});
+            const auto changes = interned.reload(PugiXmlAdapter{edited.child("streams")});
+
+            then("its values should compare equal across pools") = [&] {
+                expect(changes.modified == std::vector<std::string>{"history"});
+            };
+        };
+
+        given("a parallel interned load") = [] {
+            const StringPoolFixture fixture;
+            InternedStreamSet<PugiXmlAdapter> serial;
+            InternedStreamSet<PugiXmlAdapter> parallel;
+            serial.load_from_xml(fixture.root());
+            parallel.load_from_xml(fixture.root(), LoadOptions{.parallel = true, .max_threads = 4,
+                                                               .min_streams_per_thread = 10});
+
+            then("the pool should be shared safely between workers") = [&] {
+                expect(parallel.pool().size() == serial.pool().size());
+                const bool same_bytes = serialize(parallel.stream_set()) == serialize(serial.stream_set());
+                expect(same_bytes);
+            };
+        };
+    };
+}
+
+int main() {
+    test_string_pool();
+}
@@ -0,0 +1,253 @@
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <ut.hpp>
+#include "filesystem.hpp"
+#include "mock_xml_file_system.hpp"
+#include "parse.hpp"
+#include "test_utils.hpp"
+
+using namespace boost::ut;
+using namespace xml_stream_parser;
+using namespace xml_stream_parser::test;
+
+namespace {
+
+/// Forwards to the real system calls and counts them.
+struct CountingCalls {
+    std::shared_ptr<int> mkdirs = std::make_shared<int>(0);
+    std::shared_ptr<int> accesses = std::make_shared<int>(0);
+
+    int make_directory(const char* path) const noexcept {
+        ++*mkdirs;
+        return PosixFileCalls{}.make_directory(path);
+    }
+
+    int check_access(const char* path, int mode) const noexcept {
+        ++*accesses;
+        return PosixFileCalls{}.check_access(path, mode);
+    }
+
+    [[nodiscard]] int total() const noexcept { return *mkdirs + *accesses; }
+};
+
+/// Filesystem mock that only counts calls to the combined operation.
+class EnsureCountingFileSystem final : public IXmlFileSystem {
+public:
+    int ensure_calls{0};
+    int other_calls{0};
+
+    [[nodiscard]] bool exists(const std::string&) const noexcept override { return true; }
+    bool create_directories(const std::string&) noexcept override { ++other_calls; return true; }
+    [[nodiscard]] bool can_write(const std::string&) const noexcept override { return true; }
+
+    DirectoryStatus ensure_writable_directory(const std::string&) noexcept override {
+        ++ensure_calls;
+        return DirectoryStatus::writable;
+    }
+};
+
+} // namespace
+
+/// A scratch directory in the temp directory, removed on destruction.
+struct XmlFileSystemFixture {
+    std::filesystem::path root;
+
+    XmlFileSystemFixture() {
+        static int counter = 0;
+        root = std::filesystem::temp_directory_path() /
+               std::format("xml_stream_parser_fs_{}_{}", ::getpid(), counter++);
+        std::filesystem::create_directories(root);
+    }
+
+    ~XmlFileSystemFixture() {
+        std::error_code ec;
+        std::filesystem::remove_all(root, ec);
+    }
+
+    [[nodiscard]] std::string path(std::string_view relative) const { return (root / relative).string(); }
+};
+
+void test_xml_file_system() {
+    using namespace boost::ut::bdd;
+    "writable directory checks"_test = [] {
+        given("an existing directory") = [] {
+            const XmlFileSystemFixture fixture;
+            BasicXmlFileSystem<CountingCalls> fs;
+
+            then("ensuring it should cost one mkdir and one access check") = [&] {
+                expect(fs.ensure_writable_directory(fixture.root.string()) == DirectoryStatus::writable);
+                expect(*fs.calls().mkdirs == 1_i);
+                expect(*fs.calls().accesses == 1_i);
+            };
+        };
+
+        given("a directory two levels below an existing one") = [] {
+            const XmlFileSystemFixture fixture;
+            BasicXmlFileSystem<CountingCalls> fs;
+            const auto target = fixture.path("a/b");
+
+            then("it should be created one mkdir per level plus one retry") = [&] {
+                expect(fs.ensure_writable_directory(target) == DirectoryStatus::writable);
+                expect(std::filesystem::is_directory(target));
+                expect(*fs.calls().mkdirs == 3_i);
+                expect(*fs.calls().accesses == 1_i);
+            };
+        };
+
+        given("a regular file where a directory is expected") = [] {
+            const XmlFileSystemFixture fixture;
+            std::ofstream{fixture.path("file")} << "x";
+            XmlFileSystem fs;
+
+            then("it should not be reported as a writable directory") = [&] {
+                expect(fs.ensure_writable_directory(fixture.path("file")) == DirectoryStatus::not_writable);
+            };
+        };
+
+        given("a cached file system that found a regular file writable") = [] {
+            const XmlFileSystemFixture fixture;
+            const auto file = fixture.path("file");
+            std::ofstream{file} << "x";
+            XmlFileSystem fs{std::chrono::minutes{1}};
+            const bool writable = fs.can_write(file);
+
+            then("the file should still not be reported as a writable directory") = [&] {
+                expect(writable);
+                expect(fs.ensure_writable_directory(file) == DirectoryStatus::not_writable);
+            };
+        };
+
+        given("a path below a regular file") = [] {
+            const XmlFileSystemFixture fixture;
+            std::ofstream{fixture.path("file")} << "x";
+            XmlFileSystem fs;
+
+            then("creating it should fail") = [&] {
+                expect(fs.ensure_writable_directory(fixture.path("file/sub")) == DirectoryStatus::create_failed);
+            };
+        };
+
+        given("a file system with a writability cache") = [] {
+            const XmlFileSystemFixture fixture;
+            BasicXmlFileSystem<CountingCalls> fs{std::chrono::minutes{1}};
+
+            when("the same directory is checked many times") = [&] {
+                for (int i = 0; i < 100; ++i) {
+                    (void)fs.ensure_writable_directory(fixture.root.string());
+                    (void)fs.can_write(fixture.root.string());
+                }
+
+                then("only the first check should reach the system") = [&] {
+                    expect(fs.calls().total() == 2_i);
+                };
+            };
+
+            when("the cache is cleared") = [&] {
+                fs.clear_cache();
+                const auto before = fs.calls().total();
+                (void)fs.can_write(fixture.root.string());
+
+                then("the next check should reach the system again") = [&] {
+                    expect(fs.calls().total() == before + 1);
+                };
+            };
+        };
+
+        given("a cached file system asked about a missing directory") = [] {
+            const XmlFileSystemFixture fixture;
+            XmlFileSystem fs{std::chrono::minutes{1}};
+            const auto target = fixture.path("x/out");
+            const bool before = fs.can_write(target);
+
+            then("ensuring it afterwards should still create it") = [&] {
+                expect(!before);
+                expect(fs.ensure_writable_directory(target) == DirectoryStatus::writable);
+                expect(std::filesystem::is_directory(target));
+                expect(fs.can_write(target));
+            };
+
+            then("creating it through create_directories should refresh the check") = [&] {
+                const auto other = fixture.path("y/out");
+                expect(!fs.can_write(other));
+                expect(fs.create_directories(other));
+                expect(fs.can_write(other));
+            };
+        };
+
+        given("a cached file system that is copied and moved") = [] {
+            const XmlFileSystemFixture fixture;
+            BasicXmlFileSystem<CountingCalls> original{std::chrono::minutes{1}};
+            (void)original.can_write(fixture.root.string());
+            const auto copy = original;
+            const auto moved = std::move(original);
+
+            then("every copy should be served from the shared cache") = [&] {
+                expect(copy.can_write(fixture.root.string()));
+                expect(moved.can_write(fixture.root.string()));
+                expect(*copy.calls().accesses == 1_i);
+            };
+        };
+
+        given("a file system with an expired cache entry") = [] {
+            const XmlFileSystemFixture fixture;
+            BasicXmlFileSystem<CountingCalls> fs{std::chrono::nanoseconds{1}};
+            (void)fs.can_write(fixture.root.string());
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            (void)fs.can_write(fixture.root.string());
+
+            then("the path should be checked again") = [&] {
+                expect(*fs.calls().accesses == 2_i);
+            };
+        };
+
+        given("a file system overriding the combined operation") = [] {
+            EnsureCountingFileSystem fs;
+
+            then("build_stream_path should use it once and nothing else") = [&] {
+                build_stream_path(fs, "/data/history/file.nc");
+                expect(fs.ensure_calls == 1_i);
+                expect(fs.other_calls == 0_i);
+            };
+        };
+
+        given("a file system relying on the default combined operation") = [] {
+            RecordingFileSystem fs;
+            fs.existing.insert("/data/history");
+
+            then("an existing directory should cost one existence and one write check") = [&] {
+                expect(fs.ensure_writable_directory("/data/history") == DirectoryStatus::writable);
+                expect(fs.total_calls() == 2_i);
+                expect(fs.create_calls.empty());
+            };
+        };
+    };
+
+    "file reads"_test = [] {
+        given("a file on disk") = [] {
+            const XmlFileSystemFixture fixture;
+            std::ofstream{fixture.path("vars.txt"), std::ios::binary} << "u\r\nv\n";
+            const XmlFileSystem fs;
+
+            then("its bytes should be read unchanged") = [&] {
+                expect(fs.read_file(fixture.path("vars.txt")) == std::optional<std::string>{"u\r\nv\n"});
+            };
+
+            then("a missing file should read as empty, not throw") = [&] {
+                expect(!fs.read_file(fixture.path("missing.txt")).has_value());
+                expect(!fs.read_file(fixture.root.string()).has_value());
+            };
+        };
+    };
+}
+
+int main() {
+    test_xml_file_system();
+}